@@ -0,0 +1,228 @@
+#include <JuceHeader.h>
+#include "RenderEngine.h"
+#include <iostream>
+
+// Headless batch renderer: renders presets and/or parameter files to WAV with the plugin's render engine.
+//
+//   unfoldings-batch [--preset <name|index|all>]... [--params <file.json>]...
+//                    [--rate <Hz>] [--out <dir>] [--threads <n>] [--trace]
+//
+// A parameter file holds one object of { "paramID": plainValue, ... } or an array of them; an
+// optional "name" property names the output file. Parameters left out keep their defaults.
+// --trace also writes each job's stage timings as a Chrome / Perfetto trace next to its WAV.
+
+namespace
+{
+struct BatchJob
+{
+    juce::String name;
+    RenderRequest request;
+
+    double renderMs = 0.0;
+    double audioSeconds = 0.0;
+    bool written = false;
+};
+
+// Only there to collect a profile; batch jobs are never cancelled.
+class TraceMonitor final : public RenderMonitor
+{
+public:
+    bool shouldCancel() const override { return false; }
+    void reportProgress (RenderStage, float) override {}
+    RenderProfile* getProfile() const override { return profile.get(); }
+
+    const std::unique_ptr<RenderProfile> profile = std::make_unique<RenderProfile>();
+};
+
+void printUsage()
+{
+    std::cout << "usage: unfoldings-batch [--preset <name|index|all>]... [--params <file.json>]...\n"
+                 "                        [--rate <Hz>] [--out <dir>] [--threads <n>] [--trace]\n";
+}
+
+juce::String makeFileSafe (const juce::String& s)
+{
+    return juce::File::createLegalFileName (s.replaceCharacter (' ', '_'));
+}
+}
+
+int main (int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add (argv[i]);
+
+    if (args.isEmpty() || args.contains ("--help") || args.contains ("-h"))
+    {
+        printUsage();
+        return args.isEmpty() ? 1 : 0;
+    }
+
+    double outRate = 44100.0;
+    juce::File outDir = juce::File::getCurrentWorkingDirectory();
+    int numThreads = juce::SystemStats::getNumCpus();
+    bool writeTraces = false;
+
+    juce::StringArray presetNames;
+    for (int p = 0; p < RenderEngine::getNumPresets(); ++p)
+        presetNames.add (RenderEngine::getPreset (p).name);
+
+    std::vector<std::pair<juce::String, juce::var>> sources; // name + either a preset index or a parameter object
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const auto hasValue = i + 1 < args.size();
+
+        if (arg == "--rate" && hasValue)
+        {
+            outRate = args[++i].getDoubleValue();
+        }
+        else if (arg == "--out" && hasValue)
+        {
+            outDir = juce::File::getCurrentWorkingDirectory().getChildFile (args[++i]);
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            numThreads = juce::jmax (1, args[++i].getIntValue());
+        }
+        else if (arg == "--trace")
+        {
+            writeTraces = true;
+        }
+        else if (arg == "--preset" && hasValue)
+        {
+            const auto value = args[++i];
+
+            if (value == "all")
+            {
+                for (int p = 0; p < presetNames.size(); ++p)
+                    sources.emplace_back (presetNames[p], p);
+            }
+            else
+            {
+                const int index = value.containsOnly ("0123456789") ? value.getIntValue() : presetNames.indexOf (value, true);
+                if (! juce::isPositiveAndBelow (index, presetNames.size()))
+                {
+                    std::cerr << "unknown preset: " << value << "\n";
+                    return 1;
+                }
+
+                sources.emplace_back (presetNames[index], index);
+            }
+        }
+        else if (arg == "--params" && hasValue)
+        {
+            const juce::File file = juce::File::getCurrentWorkingDirectory().getChildFile (args[++i]);
+            const auto parsed = juce::JSON::parse (file);
+
+            if (parsed.isVoid() || parsed.isUndefined())
+            {
+                std::cerr << "could not parse parameter file: " << file.getFullPathName() << "\n";
+                return 1;
+            }
+
+            const auto* list = parsed.getArray();
+            const int count = list != nullptr ? list->size() : 1;
+
+            for (int n = 0; n < count; ++n)
+            {
+                const auto values = list != nullptr ? list->getReference (n) : parsed;
+                auto name = values.getProperty ("name", {}).toString();
+                if (name.isEmpty())
+                    name = file.getFileNameWithoutExtension() + (count > 1 ? "_" + juce::String (n) : juce::String());
+
+                sources.emplace_back (name, values);
+            }
+        }
+        else
+        {
+            std::cerr << "unrecognised argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (sources.empty() || outRate < 8000.0)
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (! outDir.createDirectory())
+    {
+        std::cerr << "could not create output directory: " << outDir.getFullPathName() << "\n";
+        return 1;
+    }
+
+    std::vector<BatchJob> jobs;
+    for (const auto& [name, source] : sources)
+    {
+        BatchJob job;
+        job.name = name;
+        job.request.outRate = outRate;
+
+        if (source.isInt())
+            job.request = RenderEngine::makePresetRequest ((int) source, outRate);
+        else if (auto* obj = source.getDynamicObject())
+            for (const auto& prop : obj->getProperties())
+                RenderEngine::setParameter (job.request, prop.name.toString(), (float) prop.value);
+
+        jobs.push_back (job);
+    }
+
+    const auto batchStart = juce::Time::getMillisecondCounterHiRes();
+    juce::ThreadPool pool (juce::ThreadPoolOptions{}.withThreadName ("unfoldings batch").withNumberOfThreads (numThreads));
+    const RenderEngine engine (nullptr, &pool);
+    std::atomic<int> remaining { (int) jobs.size() };
+    juce::WaitableEvent allDone;
+
+    for (size_t j = 0; j < jobs.size(); ++j)
+    {
+        pool.addJob ([&, j]
+        {
+            auto& job = jobs[j];
+            TraceMonitor monitor;
+            const auto start = juce::Time::getMillisecondCounterHiRes();
+            const auto result = engine.render (job.request, writeTraces ? &monitor : nullptr);
+            job.renderMs = juce::Time::getMillisecondCounterHiRes() - start;
+            job.audioSeconds = (double) result.buffer.getNumSamples() / result.sampleRate;
+
+            const auto file = outDir.getChildFile (juce::String (j).paddedLeft ('0', 3) + "_" + makeFileSafe (job.name) + ".wav");
+            job.written = RenderEngine::writeWav (file, result.buffer, result.sampleRate);
+
+            if (writeTraces)
+                job.written = monitor.profile->writeChromeTrace (file.withFileExtension ("trace.json")) && job.written;
+
+            if (--remaining == 0)
+                allDone.signal();
+        });
+    }
+
+    allDone.wait();
+    const auto batchMs = juce::Time::getMillisecondCounterHiRes() - batchStart;
+
+    std::cout << juce::String ("job").paddedRight (' ', 34) << "  mode   audio s   render ms     x RT\n";
+    double totalRenderMs = 0.0, totalAudio = 0.0;
+    bool allWritten = true;
+
+    for (const auto& job : jobs)
+    {
+        totalRenderMs += job.renderMs;
+        totalAudio += job.audioSeconds;
+        allWritten = allWritten && job.written;
+
+        std::cout << job.name.substring (0, 34).paddedRight (' ', 34)
+                  << juce::String (job.request.mode).paddedLeft (' ', 6)
+                  << juce::String (job.audioSeconds, 2).paddedLeft (' ', 10)
+                  << juce::String (job.renderMs, 1).paddedLeft (' ', 12)
+                  << juce::String (job.audioSeconds * 1000.0 / juce::jmax (1.0e-3, job.renderMs), 1).paddedLeft (' ', 9)
+                  << (job.written ? "" : "  (write failed)") << "\n";
+    }
+
+    std::cout << "\n" << jobs.size() << " renders, " << juce::String (totalAudio, 1) << " s of audio, "
+              << juce::String (totalRenderMs / 1000.0, 2) << " s summed render time, "
+              << juce::String (batchMs / 1000.0, 2) << " s wall on " << numThreads << " threads\n";
+
+    return allWritten ? 0 : 1;
+}
@@ -0,0 +1,457 @@
+#include <JuceHeader.h>
+#include "Decimator.h"
+#include "RenderEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#if JUCE_LINUX
+ #include <fstream>
+#elif JUCE_MAC
+ #include <sys/resource.h>
+#endif
+
+// Render benchmark: times the micro burst across rates and densities, each unfold kernel and the
+// post passes on a fixed reference input, the spectral unfold at every FFT size, Morphogen's two
+// partial synthesizers at a few partial counts and its reaction-diffusion grids at a few sizes, full
+// renders of every preset, and the spectral presets again with sparse synthesis.
+//
+//   unfoldings-bench [--group <micro|kernels|fft|additive|diffusion|presets|sparse>]... [--repeats <n>] [--threads <n>]
+//                    [--rate <Hz>] [--json <file>]
+//
+// Every case is run --repeats times; mean, spread and best time are reported, along with output
+// samples per second, real-time factor and peak resident memory.
+
+namespace
+{
+struct BenchResult
+{
+    juce::String group, name;
+    juce::NamedValueSet params;
+    std::vector<double> ms;
+    juce::int64 samples = 0;       // output samples per run, per channel
+    double audioSeconds = 0.0;     // audio produced per run
+    juce::int64 peakMemory = 0;    // bytes, 0 when the platform can't tell
+
+    double mean() const    { double s = 0; for (auto v : ms) s += v; return ms.empty() ? 0.0 : s / (double) ms.size(); }
+    double minimum() const { return ms.empty() ? 0.0 : *std::min_element (ms.begin(), ms.end()); }
+    double maximum() const { return ms.empty() ? 0.0 : *std::max_element (ms.begin(), ms.end()); }
+
+    double stdDev() const
+    {
+        if (ms.size() < 2)
+            return 0.0;
+
+        const auto m = mean();
+        double s = 0;
+        for (auto v : ms)
+            s += (v - m) * (v - m);
+        return std::sqrt (s / (double) (ms.size() - 1));
+    }
+};
+
+// Peak resident set size since the last reset. Linux can reset the high-water mark per case;
+// elsewhere this is the process-wide peak so far.
+void resetPeakMemory()
+{
+   #if JUCE_LINUX
+    std::ofstream ("/proc/self/clear_refs") << "5";
+   #endif
+}
+
+juce::int64 getPeakMemory()
+{
+   #if JUCE_LINUX
+    std::ifstream status ("/proc/self/status");
+    std::string line;
+    while (std::getline (status, line))
+        if (line.rfind ("VmHWM:", 0) == 0)
+            return (juce::int64) std::atoll (line.c_str() + 6) * 1024;
+    return 0;
+   #elif JUCE_MAC
+    rusage usage {};
+    getrusage (RUSAGE_SELF, &usage);
+    return (juce::int64) usage.ru_maxrss;
+   #else
+    return 0;
+   #endif
+}
+
+template <typename Fn>
+BenchResult runCase (const juce::String& group, const juce::String& name, int repeats, Fn&& runOnce)
+{
+    BenchResult r;
+    r.group = group;
+    r.name = name;
+    resetPeakMemory();
+
+    for (int i = 0; i < repeats; ++i)
+    {
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        const auto [samples, seconds] = runOnce();
+        r.ms.push_back (juce::Time::getMillisecondCounterHiRes() - start);
+        r.samples = samples;
+        r.audioSeconds = seconds;
+    }
+
+    r.peakMemory = getPeakMemory();
+
+    std::cout << (group + "/" + name).substring (0, 46).paddedRight (' ', 46)
+              << juce::String (r.mean(), 2).paddedLeft (' ', 11)
+              << juce::String (r.stdDev(), 2).paddedLeft (' ', 9)
+              << juce::String ((double) r.samples * 1000.0 / juce::jmax (1.0e-3, r.mean()) / 1.0e6, 2).paddedLeft (' ', 10)
+              << juce::String (r.audioSeconds * 1000.0 / juce::jmax (1.0e-3, r.mean()), 1).paddedLeft (' ', 9)
+              << juce::String ((double) r.peakMemory / (1024.0 * 1024.0), 1).paddedLeft (' ', 9) << "\n";
+    return r;
+}
+
+std::pair<juce::int64, double> produced (const juce::AudioBuffer<float>& b, double sampleRate)
+{
+    return { (juce::int64) b.getNumSamples(), (double) b.getNumSamples() / sampleRate };
+}
+
+juce::var toJson (const BenchResult& r)
+{
+    auto* params = new juce::DynamicObject();
+    for (const auto& p : r.params)
+        params->setProperty (p.name, p.value);
+
+    juce::Array<juce::var> runs;
+    for (auto v : r.ms)
+        runs.add (v);
+
+    const auto meanSeconds = juce::jmax (1.0e-9, r.mean() / 1000.0);
+
+    auto* o = new juce::DynamicObject();
+    o->setProperty ("group", r.group);
+    o->setProperty ("name", r.name);
+    o->setProperty ("params", juce::var (params));
+    o->setProperty ("runsMs", runs);
+    o->setProperty ("meanMs", r.mean());
+    o->setProperty ("stdDevMs", r.stdDev());
+    o->setProperty ("minMs", r.minimum());
+    o->setProperty ("maxMs", r.maximum());
+    o->setProperty ("samples", r.samples);
+    o->setProperty ("samplesPerSecond", (double) r.samples / meanSeconds);
+    o->setProperty ("realtimeFactor", r.audioSeconds / meanSeconds);
+    o->setProperty ("peakMemoryBytes", r.peakMemory);
+    return juce::var (o);
+}
+
+class ProfileMonitor final : public RenderMonitor
+{
+public:
+    bool shouldCancel() const override { return false; }
+    void reportProgress (RenderStage, float) override {}
+    RenderProfile* getProfile() const override { return profile.get(); }
+
+    const std::unique_ptr<RenderProfile> profile = std::make_unique<RenderProfile>();
+};
+
+void printUsage()
+{
+    std::cout << "usage: unfoldings-bench [--group <micro|kernels|fft|additive|diffusion|presets|sparse>]... [--repeats <n>] [--threads <n>]\n"
+                 "                        [--rate <Hz>] [--json <file>]\n";
+}
+}
+
+int main (int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add (argv[i]);
+
+    if (args.contains ("--help") || args.contains ("-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    juce::StringArray groups;
+    int repeats = 5;
+    int numThreads = juce::SystemStats::getNumCpus();
+    double outRate = 44100.0;
+    juce::File jsonFile;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const auto hasValue = i + 1 < args.size();
+
+        if (arg == "--group" && hasValue)         groups.add (args[++i]);
+        else if (arg == "--repeats" && hasValue)  repeats = juce::jmax (1, args[++i].getIntValue());
+        else if (arg == "--threads" && hasValue)  numThreads = juce::jmax (0, args[++i].getIntValue());
+        else if (arg == "--rate" && hasValue)     outRate = juce::jmax (8000.0, args[++i].getDoubleValue());
+        else if (arg == "--json" && hasValue)     jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile (args[++i]);
+        else
+        {
+            std::cerr << "unrecognised argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (groups.isEmpty())
+        groups.addArray ({ "micro", "kernels", "fft", "additive", "diffusion", "presets", "sparse" });
+
+    // --threads 0 runs the parallel branches inline on the calling thread.
+    std::unique_ptr<juce::ThreadPool> pool;
+    if (numThreads > 0)
+        pool = std::make_unique<juce::ThreadPool> (juce::ThreadPoolOptions{}.withThreadName ("unfoldings bench").withNumberOfThreads (numThreads));
+
+    const RenderEngine engine (nullptr, pool.get());
+    std::vector<BenchResult> results;
+
+    std::cout << juce::String ("case").paddedRight (' ', 46) << "    mean ms   +/- ms   Msmp/s     x RT   peak MB\n";
+
+    if (groups.contains ("micro"))
+    {
+        for (int choice = 0; choice < RenderEngine::numMicroRateChoices; ++choice)
+        {
+            const auto microRate = RenderEngine::getMicroRateForChoice (choice);
+            const auto maxDensity = RenderEngine::getMaxDensity (microRate);
+
+            // The densities the engine allows at this rate, then its cap (a million events at 192 kHz).
+            std::vector<int> densities;
+            for (int density : { 500, 2000, 6000, 12000, 20000, 30000, 120000 })
+                if (density < maxDensity)
+                    densities.push_back (density);
+            densities.push_back (maxDensity);
+
+            for (int density : densities)
+            {
+                const RenderRequest defaults;
+
+                auto r = runCase ("micro", "burst " + juce::String ((int) (microRate / 1000.0)) + "k d" + juce::String (density), repeats, [&]
+                {
+                    return produced (engine.renderMicroBurst (microRate, defaults.burstMs, density), microRate);
+                });
+
+                r.params.set ("microRate", microRate);
+                r.params.set ("burstMs", defaults.burstMs);
+                r.params.set ("density", density);
+                results.push_back (std::move (r));
+            }
+        }
+    }
+
+    if (groups.contains ("kernels"))
+    {
+        // Every kernel sees the default request's micro burst, so numbers compare across versions.
+        RenderRequest q;
+        q.outRate = outRate;
+
+        const auto micro = engine.renderMicroBurst (q.microRate, q.burstMs, q.density);
+        const auto spectral = engine.unfoldSpectral (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, q.fftSize, q.spectralFloorDb, q.seed);
+        const auto granular = engine.unfoldGranular (micro, q.microRate, q.outRate, q.outSeconds, q.grainMs, q.overlap, q.seed);
+
+        auto kernel = [&] (const juce::String& name, auto&& fn)
+        {
+            auto r = runCase ("kernels", name, repeats, [&] { return produced (fn(), q.outRate); });
+            r.params.set ("microRate", q.microRate);
+            r.params.set ("outRate", q.outRate);
+            r.params.set ("outSeconds", q.outSeconds);
+            results.push_back (std::move (r));
+        };
+
+        // The in-place passes get a fresh copy each run; the copy is timed too, but is negligible.
+        auto inPlace = [&] (const juce::String& name, auto&& fn)
+        {
+            kernel (name, [&] { juce::AudioBuffer<float> b (spectral); fn (b); return b; });
+        };
+
+        kernel ("decimate", [&]
+        {
+            const auto mono = RenderEngine::toMono (micro);
+            juce::AudioBuffer<float> out (1, (int) std::round (mono.getNumSamples() * q.outRate / q.microRate));
+            Decimator::get (q.microRate, q.outRate)->process (mono.getReadPointer (0), mono.getNumSamples(), out.getWritePointer (0), out.getNumSamples());
+            return out;
+        });
+        kernel ("granular", [&] { return engine.unfoldGranular (micro, q.microRate, q.outRate, q.outSeconds, q.grainMs, q.overlap, q.seed); });
+        kernel ("spectral", [&] { return engine.unfoldSpectral (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, q.fftSize, q.spectralFloorDb, q.seed); });
+        kernel ("xeno", [&] { return engine.unfoldXeno (spectral, granular, q.outRate, q.stretch, q.warp, q.spectralChaos, q.hybridMix, q.seed); });
+        kernel ("morphogen", [&] { return engine.unfoldMorphogen (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, q.hybridMix, q.fftSize, q.morphogenSynth, q.morphogenBins, q.morphogenField, q.morphogenCells, q.seed); });
+        kernel ("fennesz", [&] { return engine.unfoldFennesz (spectral, granular, q.outRate, q.spectralChaos, q.hybridMix, q.seed); });
+        kernel ("noto", [&] { return engine.unfoldNoto (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, q.seed); });
+        kernel ("ikeda", [&] { return engine.unfoldIkeda (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, q.seed); });
+        inPlace ("bloom", [&] (auto& b) { RenderEngine::applyBloomInPlace (b, q.outRate, q.seed + 11731, 0.6f); });
+        inPlace ("sanitize", [] (auto& b) { RenderEngine::sanitizeBufferInPlace (b); });
+        inPlace ("normalize", [] (auto& b) { RenderEngine::normalizeInPlace (b); });
+    }
+
+    if (groups.contains ("fft"))
+    {
+        // The spectral unfold of the kernels' reference input at each analysis resolution.
+        RenderRequest q;
+        q.outRate = outRate;
+
+        const auto micro = engine.renderMicroBurst (q.microRate, q.burstMs, q.density);
+
+        // Sizes from smallest to largest, then multi-resolution (choice 0).
+        for (int choice = 1; choice <= RenderEngine::numFFTSizeChoices; ++choice)
+        {
+            const auto fftSize = RenderEngine::getFFTSizeForChoice (choice % RenderEngine::numFFTSizeChoices);
+            auto r = runCase ("fft", fftSize > 0 ? "spectral " + juce::String (fftSize) : juce::String ("spectral multi-resolution"), repeats, [&]
+            {
+                return produced (engine.unfoldSpectral (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, fftSize, q.spectralFloorDb, q.seed), q.outRate);
+            });
+
+            r.params.set ("fftSize", fftSize);
+            r.params.set ("outSeconds", q.outSeconds);
+            results.push_back (std::move (r));
+        }
+    }
+
+    if (groups.contains ("additive"))
+    {
+        // Morphogen on the kernels' reference input, its partials run as oscillators or resynthesized
+        // by inverse FFT. Oscillators stop at 512 partials, past which a run takes minutes.
+        RenderRequest q;
+        q.outRate = outRate;
+
+        const auto micro = engine.renderMicroBurst (q.microRate, q.burstMs, q.density);
+
+        for (int synth : { RenderEngine::morphogenOscillators, RenderEngine::morphogenIFFT })
+        {
+            for (int bins : { 0, 512, RenderEngine::maxMorphogenBins })
+            {
+                if (synth == RenderEngine::morphogenOscillators && bins > 512)
+                    continue;
+
+                const auto name = juce::String (synth == RenderEngine::morphogenIFFT ? "ifft " : "oscillators ")
+                                + (bins > 0 ? juce::String (bins) : juce::String ("auto"));
+
+                auto r = runCase ("additive", name, repeats, [&]
+                {
+                    return produced (engine.unfoldMorphogen (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, q.hybridMix,
+                                                             q.fftSize, synth, bins, q.morphogenField, q.morphogenCells, q.seed), q.outRate);
+                });
+
+                r.params.set ("morphogenSynth", synth);
+                r.params.set ("morphogenBins", bins);
+                r.params.set ("outSeconds", q.outSeconds);
+                results.push_back (std::move (r));
+            }
+        }
+    }
+
+    if (groups.contains ("diffusion"))
+    {
+        // Morphogen's reaction-diffusion as a ring or a plane at a few grid sizes (partials x time
+        // cells), resynthesized by inverse FFT so the grid dominates. Its own time is read back from a
+        // profile. The larger planes are requested as such but run at maxMorphogenPlaneCells.
+        RenderRequest q;
+        q.outRate = outRate;
+
+        const auto micro = engine.renderMicroBurst (q.microRate, q.burstMs, q.density);
+
+        struct Grid { int field, bins, cells; };
+        for (const auto g : { Grid { RenderEngine::morphogenRing, 0, 0 }, Grid { RenderEngine::morphogenPlane, 0, 0 },
+                              Grid { RenderEngine::morphogenRing, 1024, 1024 }, Grid { RenderEngine::morphogenPlane, 1024, 1024 },
+                              Grid { RenderEngine::morphogenPlane, 2048, 2048 },
+                              Grid { RenderEngine::morphogenPlane, RenderEngine::maxMorphogenBins, RenderEngine::maxMorphogenCells } })
+        {
+            const auto unfold = [&] (const RenderMonitor* monitor)
+            {
+                return engine.unfoldMorphogen (micro, q.microRate, q.outRate, q.outSeconds, q.stretch, q.warp, q.spectralChaos, q.hybridMix,
+                                               q.fftSize, RenderEngine::morphogenIFFT, g.bins, g.field, g.cells, q.seed, monitor);
+            };
+
+            ProfileMonitor monitor;
+            unfold (&monitor);
+
+            double diffusionMs = 0.0;
+            for (const auto& span : monitor.profile->getSpans())
+                if (span.name == "reaction-diffusion")
+                    diffusionMs += span.durationMs;
+
+            const auto name = juce::String (g.field == RenderEngine::morphogenPlane ? "plane " : "ring ")
+                            + (g.bins > 0 ? juce::String (g.bins) + " x " + juce::String (g.cells) : juce::String ("auto"))
+                            + ", rd " + juce::String (juce::roundToInt (diffusionMs)) + " ms";
+
+            auto r = runCase ("diffusion", name, repeats, [&] { return produced (unfold (nullptr), q.outRate); });
+
+            r.params.set ("morphogenField", g.field);
+            r.params.set ("morphogenBins", g.bins);
+            r.params.set ("morphogenCells", g.cells);
+            r.params.set ("diffusionMs", diffusionMs);
+            results.push_back (std::move (r));
+        }
+    }
+
+    if (groups.contains ("presets"))
+    {
+        for (int p = 0; p < RenderEngine::getNumPresets(); ++p)
+        {
+            const auto request = RenderEngine::makePresetRequest (p, outRate);
+            auto r = runCase ("presets", RenderEngine::getPreset (p).name, repeats, [&]
+            {
+                const auto result = engine.render (request);
+                return produced (result.buffer, result.sampleRate);
+            });
+
+            r.params.set ("index", p);
+            r.params.set ("mode", request.mode);
+            r.params.set ("microRate", request.microRate);
+            r.params.set ("density", request.density);
+            r.params.set ("outSeconds", request.outSeconds);
+            results.push_back (std::move (r));
+        }
+    }
+
+    if (groups.contains ("sparse"))
+    {
+        // Presets that go through the spectral unfold, rendered with a spectral floor; the share of
+        // bins it skipped is read back from a profile.
+        constexpr float floorDb = -40.0f;
+
+        for (int p = 0; p < RenderEngine::getNumPresets(); ++p)
+        {
+            auto request = RenderEngine::makePresetRequest (p, outRate);
+            if (request.mode != 1 && request.mode != 2 && request.mode != 3 && request.mode != 5)
+                continue;
+
+            request.spectralFloorDb = floorDb;
+            ProfileMonitor monitor;
+            engine.render (request, &monitor);
+            const auto skipped = monitor.profile->getSkippedBinFraction();
+
+            auto r = runCase ("sparse", juce::String (RenderEngine::getPreset (p).name) + " " + juce::String (juce::roundToInt (100.0 * skipped)) + "% skipped", repeats, [&]
+            {
+                const auto result = engine.render (request);
+                return produced (result.buffer, result.sampleRate);
+            });
+
+            r.params.set ("index", p);
+            r.params.set ("mode", request.mode);
+            r.params.set ("spectralFloorDb", floorDb);
+            r.params.set ("skippedBinFraction", skipped);
+            results.push_back (std::move (r));
+        }
+    }
+
+    if (jsonFile != juce::File())
+    {
+        juce::Array<juce::var> list;
+        for (const auto& r : results)
+            list.add (toJson (r));
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("version", ProjectInfo::versionString);
+        root->setProperty ("timestamp", juce::Time::getCurrentTime().toISO8601 (true));
+        root->setProperty ("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty ("numCpus", juce::SystemStats::getNumCpus());
+        root->setProperty ("threads", numThreads);
+        root->setProperty ("repeats", repeats);
+        root->setProperty ("outRate", outRate);
+        root->setProperty ("results", list);
+
+        if (! jsonFile.replaceWithText (juce::JSON::toString (juce::var (root))))
+        {
+            std::cerr << "could not write " << jsonFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,266 @@
+#include "Decimator.h"
+#include <array>
+#include <cmath>
+
+namespace
+{
+constexpr int halfBandPairs = 8;         // non-zero taps on each side of the centre: a 31-tap filter
+constexpr int zeroCrossings = 24;        // of the final sinc, per side, at the output rate
+constexpr int numPhases = 256;           // phase rows, interpolated linearly in between
+constexpr double kaiserBeta = 7.86;      // about 80 dB of stopband rejection
+
+double besselI0 (double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k)
+    {
+        term *= (x * 0.5 / k) * (x * 0.5 / k);
+        sum += term;
+    }
+    return sum;
+}
+
+// Kaiser window at position x in [-1, 1].
+double kaiser (double x)
+{
+    return std::abs (x) >= 1.0 ? 0.0 : besselI0 (kaiserBeta * std::sqrt (1.0 - x * x)) / besselI0 (kaiserBeta);
+}
+
+double sinc (double x)
+{
+    return std::abs (x) < 1.0e-12 ? 1.0 : std::sin (juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+}
+
+// Odd taps 1, 3, 5... of the half-band filter (the centre tap is 0.5, the even ones are zero),
+// scaled for unity gain at DC.
+const std::array<float, halfBandPairs>& getHalfBandCoefficients()
+{
+    static const auto coefficients = []
+    {
+        std::array<double, halfBandPairs> c {};
+        double sum = 0.0;
+
+        for (int k = 0; k < halfBandPairs; ++k)
+        {
+            const int j = 2 * k + 1;
+            c[(size_t) k] = 0.5 * sinc (0.5 * j) * kaiser ((double) j / (2.0 * halfBandPairs));
+            sum += c[(size_t) k];
+        }
+
+        std::array<float, halfBandPairs> result {};
+        for (size_t k = 0; k < result.size(); ++k)
+            result[k] = (float) (c[k] * 0.25 / sum);
+
+        return result;
+    }();
+
+    return coefficients;
+}
+
+// out[i] = 0.5 in[2i] + sum_k c_k (in[2i - 2k - 1] + in[2i + 2k + 1]) for the first numOut outputs,
+// reading in[1 - 2 halfBandPairs] to in[2 numOut + 2 halfBandPairs - 3]. The odd input samples are
+// split out first, so each tap becomes a contiguous, vectorizable pass.
+void halveRate (const float* in, int numOut, float* out, std::vector<float>& odd)
+{
+    const auto& c = getHalfBandCoefficients();
+
+    odd.resize ((size_t) (numOut + 2 * halfBandPairs - 1));
+    for (int j = 0; j < (int) odd.size(); ++j)
+        odd[(size_t) j] = in[2 * (j - halfBandPairs) + 1];
+
+    for (int i = 0; i < numOut; ++i)
+        out[i] = 0.5f * in[2 * i];
+
+    for (int k = 0; k < halfBandPairs; ++k)
+    {
+        const auto ck = c[(size_t) k];
+        const auto* before = odd.data() + halfBandPairs - k - 1;
+        const auto* after = odd.data() + halfBandPairs + k;
+
+        for (int i = 0; i < numOut; ++i)
+            out[i] += ck * (before[i] + after[i]);
+    }
+}
+}
+
+Decimator::Decimator (double inputRateIn, double outputRateIn)
+    : inputRate (inputRateIn), outputRate (outputRateIn)
+{
+    jassert (inputRate > 0.0 && outputRate > 0.0);
+
+    auto rate = inputRate;
+    while (rate * 0.5 >= 2.0 * outputRate)
+    {
+        rate *= 0.5;
+        ++numHalfBandStages;
+    }
+
+    finalRatio = rate / outputRate;
+
+    // Cut off at whichever Nyquist is lower, measured in stage-input samples.
+    const auto cutoff = 0.5 * juce::jmin (1.0, 1.0 / finalRatio);
+    halfWidth = (int) std::ceil (zeroCrossings / (2.0 * cutoff));
+    tapsPerPhase = 2 * halfWidth + 1;
+    phaseTable.resize ((size_t) ((numPhases + 1) * tapsPerPhase));
+
+    for (int p = 0; p <= numPhases; ++p)
+    {
+        auto* row = phaseTable.data() + p * tapsPerPhase;
+        const auto frac = (double) p / numPhases;
+        double sum = 0.0;
+
+        std::vector<double> h ((size_t) tapsPerPhase);
+        for (int j = 0; j < tapsPerPhase; ++j)
+        {
+            const auto t = (double) (j - halfWidth) - frac;
+            h[(size_t) j] = 2.0 * cutoff * sinc (2.0 * cutoff * t) * kaiser (t / (halfWidth + 1));
+            sum += h[(size_t) j];
+        }
+
+        for (int j = 0; j < tapsPerPhase; ++j)
+            row[j] = (float) (h[(size_t) j] / sum);
+    }
+}
+
+std::shared_ptr<const Decimator> Decimator::get (double inputRate, double outputRate)
+{
+    static juce::CriticalSection lock;
+    static std::vector<std::shared_ptr<const Decimator>> recent;
+    constexpr size_t maxRecent = 16;
+
+    const juce::ScopedLock sl (lock);
+
+    for (auto it = recent.begin(); it != recent.end(); ++it)
+    {
+        if (juce::exactlyEqual ((*it)->inputRate, inputRate) && juce::exactlyEqual ((*it)->outputRate, outputRate))
+        {
+            auto found = *it;
+            recent.erase (it);
+            recent.push_back (found);
+            return found;
+        }
+    }
+
+    if (recent.size() >= maxRecent)
+        recent.erase (recent.begin());
+
+    recent.push_back (std::make_shared<const Decimator> (inputRate, outputRate));
+    return recent.back();
+}
+
+void Decimator::process (const float* input, int numInputSamples, float* output, int numOutputSamples) const
+{
+    // Streamed in blocks, which keeps each stage's working set in cache.
+    constexpr int blockSize = 16384;
+    Stream stream (*this, numInputSamples, output, numOutputSamples);
+
+    for (int start = 0; start < numInputSamples; start += blockSize)
+        stream.push (input + start, juce::jmin (blockSize, numInputSamples - start));
+}
+
+//==============================================================================
+Decimator::Stream::Stream (const Decimator& decimatorIn, int numInputSamples, float* outputIn, int numOutputSamplesIn)
+    : decimator (decimatorIn), output (outputIn), numOutputSamples (juce::jmax (0, numOutputSamplesIn)),
+      halfBandStages ((size_t) decimatorIn.numHalfBandStages), halfBandOutputs ((size_t) decimatorIn.numHalfBandStages)
+{
+    // Each half-band stage sees silence before its input starts and past its end.
+    auto n = juce::jmax (0, numInputSamples);
+    for (auto& s : halfBandStages)
+    {
+        s.numInput = n;
+        s.historyStart = -2 * halfBandPairs;
+        s.history.assign ((size_t) (2 * halfBandPairs), 0.0f);
+        n = (n + 1) / 2;
+    }
+
+    finalStage.numInput = n;
+
+    if (numInputSamples <= 0)
+        push (nullptr, 0);
+}
+
+void Decimator::Stream::push (const float* input, int numSamples)
+{
+    for (size_t s = 0; s < halfBandStages.size(); ++s)
+    {
+        auto& stage = halfBandStages[s];
+        const auto numOutput = s + 1 < halfBandStages.size() ? halfBandStages[s + 1].numInput : finalStage.numInput;
+        pushHalfBand (stage, numOutput, input, numSamples, halfBandOutputs[s]);
+
+        input = halfBandOutputs[s].data();
+        numSamples = (int) halfBandOutputs[s].size();
+    }
+
+    pushFinal (input, numSamples);
+}
+
+void Decimator::Stream::pushHalfBand (Stage& s, int numOutput, const float* input, int numSamples, std::vector<float>& produced)
+{
+    s.history.insert (s.history.end(), input, input + numSamples);
+    s.received += numSamples;
+
+    if (! s.complete && s.received >= s.numInput)
+    {
+        s.history.resize (s.history.size() + (size_t) (2 * halfBandPairs), 0.0f);
+        s.complete = true;
+    }
+
+    // Output i needs input up to 2i + 2 halfBandPairs - 1.
+    const int ready = s.complete ? numOutput
+                                 : juce::jmin (numOutput, s.received >= 2 * halfBandPairs ? (s.received - 2 * halfBandPairs) / 2 + 1 : 0);
+
+    produced.resize ((size_t) juce::jmax (0, ready - s.produced));
+    if (produced.empty())
+        return;
+
+    halveRate (s.history.data() + (2 * s.produced - s.historyStart), (int) produced.size(), produced.data(), odd);
+    s.produced = ready;
+
+    const int keepFrom = 2 * s.produced - 2 * halfBandPairs + 1;
+    s.history.erase (s.history.begin(), s.history.begin() + (keepFrom - s.historyStart));
+    s.historyStart = keepFrom;
+}
+
+void Decimator::Stream::pushFinal (const float* input, int numSamples)
+{
+    auto& s = finalStage;
+    s.history.insert (s.history.end(), input, input + numSamples);
+    s.received += numSamples;
+    s.complete = s.received >= s.numInput;
+
+    const auto& d = decimator;
+    int first = 0;
+
+    for (; s.produced < numOutputSamples; ++s.produced)
+    {
+        // The filter for the exact fractional position is interpolated between the two phase rows
+        // around it. Taking the nearest row alone would misplace each output by up to 1 / 512 of an
+        // input sample, an error of about -51 dB at 20 kHz from an 88.2 kHz stage input.
+        const auto centre = (double) s.produced * d.finalRatio;
+        const auto base = (int) centre;
+        const auto position = (centre - base) * numPhases;
+        const auto phase = juce::jmin ((int) position, numPhases - 1);
+        const auto weight = (float) (position - phase);
+
+        first = base - d.halfWidth;
+        if (! s.complete && first + d.tapsPerPhase > s.received)
+            break;
+
+        const auto* h0 = d.phaseTable.data() + phase * d.tapsPerPhase;
+        const auto* h1 = h0 + d.tapsPerPhase;
+        const int from = juce::jmax (0, -first);
+        const int to = juce::jmin (d.tapsPerPhase, s.numInput - first);
+        const auto* x = s.history.data() + (first + from - s.historyStart);
+
+        float sum = 0.0f;
+        for (int j = from; j < to; ++j)
+            sum += (h0[j] + weight * (h1[j] - h0[j])) * x[j - from];
+
+        output[s.produced] = sum;
+    }
+
+    // Outputs only move forwards through the input, so anything before the next one's first tap can go.
+    const int keepFrom = juce::jlimit (s.historyStart, s.received, first);
+    s.history.erase (s.history.begin(), s.history.begin() + (keepFrom - s.historyStart));
+    s.historyStart = keepFrom;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <memory>
+#include <vector>
+
+// Band-limited conversion from a micro rate down to a host rate. Half-band FIR stages halve the
+// rate while that still leaves at least twice the target, then one polyphase windowed-sinc FIR,
+// interpolated between its phases, covers the remaining, possibly fractional, ratio. Both filters
+// are linear phase and centred, so output sample i lines up with input time i / outputRate.
+class Decimator
+{
+public:
+    Decimator (double inputRate, double outputRate);
+
+    // A shared instance for this rate pair, so the coefficient tables are only built once.
+    static std::shared_ptr<const Decimator> get (double inputRate, double outputRate);
+
+    // Samples outside the input are taken as silence. Thread-safe.
+    void process (const float* input, int numInputSamples, float* output, int numOutputSamples) const;
+
+    // Takes an input of known length a block at a time, in order, and writes exactly what process()
+    // would for the whole of it. Each output sample is written as soon as the input it depends on
+    // has arrived, and each stage only holds a filter's length of its input. The decimator and the
+    // output must outlive the stream.
+    class Stream
+    {
+    public:
+        Stream (const Decimator& decimator, int numInputSamples, float* output, int numOutputSamples);
+
+        // The blocks must add up to numInputSamples; the one that completes the input flushes the filters.
+        void push (const float* input, int numSamples);
+
+    private:
+        struct Stage
+        {
+            std::vector<float> history;   // the stage's input from sample historyStart on
+            int historyStart = 0, numInput = 0, received = 0, produced = 0;
+            bool complete = false;
+        };
+
+        void pushHalfBand (Stage& s, int numOutput, const float* input, int numSamples, std::vector<float>& produced);
+        void pushFinal (const float* input, int numSamples);
+
+        const Decimator& decimator;
+        float* const output;
+        const int numOutputSamples;
+        std::vector<Stage> halfBandStages;
+        std::vector<std::vector<float>> halfBandOutputs;
+        Stage finalStage;
+        std::vector<float> odd;
+
+        JUCE_DECLARE_NON_COPYABLE (Stream)
+    };
+
+    double getInputRate() const noexcept       { return inputRate; }
+    double getOutputRate() const noexcept      { return outputRate; }
+    int getNumHalfBandStages() const noexcept  { return numHalfBandStages; }
+
+private:
+    const double inputRate, outputRate;
+    int numHalfBandStages = 0;
+    double finalRatio = 1.0; // input samples per output sample once the half-band stages have run
+    int halfWidth = 0, tapsPerPhase = 0;
+    std::vector<float> phaseTable; // rows of tapsPerPhase coefficients for fractional phases 0 to 1 inclusive
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Decimator)
+};
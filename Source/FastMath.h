@@ -0,0 +1,116 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include <cstring>
+
+// Branch-free stand-ins for the libm calls in the engine's per-bin loops, so those loops vectorize.
+// Each one's error bound is checked against libm by unfoldings-verify before it renders anything.
+//
+// Built with MICROSOUND_EXACT_MATH=1, the engine renders with the libm versions at the end of this
+// file in their place. That build records the reference audio that changes to the approximations
+// are held to, through unfoldings-verify's tolerances (see README).
+#ifndef MICROSOUND_EXACT_MATH
+ #define MICROSOUND_EXACT_MATH 0
+#endif
+
+namespace FastMath
+{
+
+// sin (2 pi x) for a phase of up to 2^31 turns either way: reduced in double, then an odd polynomial over a
+// quarter turn in float (error below 1e-6). Branch-free, so loops over it vectorize.
+inline float sinTurns (double turns) noexcept
+{
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+    const auto x = (float) (turns - (double) (int) (turns + std::copysign (0.5, turns)));
+    const auto a = std::abs (x);
+    const auto r = twoPi * std::copysign (juce::jmin (a, 0.5f - a), x);
+    const auto r2 = r * r;
+    return r * (1.0f + r2 * (-1.0f / 6.0f + r2 * (1.0f / 120.0f + r2 * (-1.0f / 5040.0f
+              + r2 * (1.0f / 362880.0f + r2 * (-1.0f / 39916800.0f))))));
+}
+
+// tanh to within 1e-4: JUCE's Pade approximation, clamped to the range where it holds. Branch-free.
+inline float fastTanh (float x) noexcept
+{
+    return juce::dsp::FastMathApproximations::tanh (juce::jlimit (-4.97f, 4.97f, x));
+}
+
+// atan2 to within 4e-7 rad: folded to an argument of at most tan (pi / 8), where the Taylor series
+// to t^13 is enough. Branch-free, with nothing computed conditionally, so loops over it vectorize.
+// atan2 (0, 0) is 0.
+inline float fastAtan2 (float y, float x) noexcept
+{
+    constexpr float pi = juce::MathConstants<float>::pi;
+
+    const auto ax = std::abs (x), ay = std::abs (y);
+    const auto q = juce::jmin (ax, ay) / juce::jmax (ax, ay, 1.0e-30f);
+    const auto folded = (q - 1.0f) / (q + 1.0f);
+    const bool upper = q > 0.41421356f;
+    const auto t = upper ? folded : q;
+    const auto t2 = t * t;
+
+    auto a = t * (1.0f + t2 * (-1.0f / 3.0f + t2 * (1.0f / 5.0f + t2 * (-1.0f / 7.0f + t2 * (1.0f / 9.0f
+                 + t2 * (-1.0f / 11.0f + t2 * (1.0f / 13.0f)))))));
+    a += upper ? 0.25f * pi : 0.0f;
+    a = ay > ax ? 0.5f * pi - a : a;
+    a = x < 0.0f ? pi - a : a;
+    return std::copysign (a, y);
+}
+
+// exp (x) as 2^n times a Taylor series for 2^f, |f| <= 1/2: relative error below 5e-7 for |x| <= 4,
+// growing to 4e-6 at |x| = 80 from the rounding of x / ln 2. Flushes to 2^-126 below about -87.
+// n is rounded by adding 1.5 * 2^23, which leaves it in the low mantissa bits, rather than by a
+// float to int conversion, which would stop loops over this from vectorizing.
+inline float fastExp (float x) noexcept
+{
+    constexpr float roundingShift = 12582912.0f;
+
+    const auto t = juce::jlimit (-126.0f, 126.0f, x * 1.44269504f);
+    const auto shifted = t + roundingShift;
+    const auto f = (t - (shifted - roundingShift)) * 0.69314718f;
+    const auto p = 1.0f + f * (1.0f + f * (0.5f + f * (1.0f / 6.0f + f * (1.0f / 24.0f + f * (1.0f / 120.0f + f * (1.0f / 720.0f))))));
+
+    juce::int32 bits;
+    std::memcpy (&bits, &shifted, sizeof (bits));
+    bits = (bits - 0x4b400000 + 127) << 23;
+
+    float scale;
+    std::memcpy (&scale, &bits, sizeof (scale));
+    return p * scale;
+}
+
+// x - 2 pi round (x / 2 pi), a phase in [-pi, pi], to within 2e-7 for |x| up to 10^4. The turns are
+// counted in double, so n is only ever off by one at an exact tie. 2 pi is then taken off in three
+// parts, the first two short enough that their multiples, and the differences, are exact in float;
+// a plain x - n 2 pi would be off by up to half an ulp of x. Branch-free.
+inline float wrapPhase (float x) noexcept
+{
+    const auto turns = (double) x * (1.0 / juce::MathConstants<double>::twoPi);
+    const auto n = (float) (int) (turns + std::copysign (0.5, turns));
+    return ((x - n * 6.28125f) - n * 0.00193548203f) + n * 1.74845553e-7f;
+}
+
+// The libm versions, in double and rounded to float.
+inline float exactSinTurns (double turns) noexcept
+{
+    return (float) std::sin (juce::MathConstants<double>::twoPi * (turns - std::round (turns)));
+}
+
+inline float exactAtan2 (float y, float x) noexcept
+{
+    return (float) std::atan2 ((double) y, (double) x);
+}
+
+inline float exactExp (float x) noexcept
+{
+    return (float) std::exp ((double) x);
+}
+
+inline float exactWrapPhase (float x) noexcept
+{
+    return (float) std::remainder ((double) x, juce::MathConstants<double>::twoPi);
+}
+
+} // namespace FastMath
@@ -81,7 +81,7 @@ void paintBrushedMetal (juce::Graphics& g, juce::Rectangle<int> bounds)
 MicrosoundSymphonyAudioProcessorEditor::MicrosoundSymphonyAudioProcessorEditor (MicrosoundSymphonyAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
-    setSize (960, 620);
+    setSize (960, 830);
 
     titleLabel.setText ("unfoldings", juce::dontSendNotification);
     titleLabel.setJustificationType (juce::Justification::centredLeft);
@@ -94,8 +94,20 @@ MicrosoundSymphonyAudioProcessorEditor::MicrosoundSymphonyAudioProcessorEditor (
     presetBox.setTextWhenNothingSelected ("Choose preset...");
     beautySceneBox.addItemList (juce::StringArray { "Off", "Lush", "Crystalline", "Dramatic" }, 1);
     microRateBox.addItemList (juce::StringArray { "192000", "384000", "768000", "1536000" }, 1);
-
-    for (auto* c : { &modeBox, &presetBox, &beautySceneBox, &microRateBox })
+    fftSizeBox.addItemList (juce::StringArray { "Multi-resolution", "256", "512", "1024", "2048", "4096", "8192", "16384" }, 1);
+    extendedMicroRateBox.addItemList (juce::StringArray { "Off", "6144000", "12288000" }, 1);
+    extendedMicroRateBox.setName ("Extended Micro Rate");
+    extendedMicroRateBox.setTooltip ("Micro rates past Micro Rate's choices; Off leaves Micro Rate in charge");
+    morphogenSynthBox.addItemList (juce::StringArray { "Oscillators", "Inverse FFT" }, 1);
+    morphogenSynthBox.setName ("Morphogen Synthesis");
+    morphogenSynthBox.setTooltip ("Morphogen's partials as an oscillator each, or by inverse-FFT overlap-add, "
+                                  "which stays fast with thousands of them");
+    morphogenFieldBox.addItemList (juce::StringArray { "Ring", "Plane" }, 1);
+    morphogenFieldBox.setName ("Morphogen Field");
+    morphogenFieldBox.setTooltip ("Morphogen's reaction-diffusion as a ring of partials stepped through time, "
+                                  "or as a plane of time x partials");
+
+    for (auto* c : { &modeBox, &presetBox, &beautySceneBox, &microRateBox, &fftSizeBox, &extendedMicroRateBox, &morphogenSynthBox, &morphogenFieldBox })
     {
         c->setColour (juce::ComboBox::backgroundColourId, juce::Colour (0xFFD3D3D3));
         c->setColour (juce::ComboBox::textColourId, juce::Colour (0xFF222222));
@@ -128,6 +140,27 @@ MicrosoundSymphonyAudioProcessorEditor::MicrosoundSymphonyAudioProcessorEditor (
     loopButton.setColour (juce::ToggleButton::textColourId, juce::Colour (0xFF2A2A2A));
     addAndMakeVisible (loopButton);
 
+    setupHorizontalSlider (playbackRateSlider, "Speed");
+    playbackRateSlider.setDoubleClickReturnValue (true, 1.0);
+
+    setupHorizontalSlider (extendedDensitySlider, "Extended Density");
+    extendedDensitySlider.setDoubleClickReturnValue (true, 0.0);
+    extendedDensitySlider.setTooltip ("Micro-burst events past Density's range, up to a million; 0 leaves Density in charge. "
+                                      "Higher micro rates allow fewer, down to about 16000 at 12.288 MHz");
+
+    setupHorizontalSlider (spectralFloorSlider, "Spectral Floor");
+    spectralFloorSlider.setDoubleClickReturnValue (true, 0.0);
+    spectralFloorSlider.setTooltip ("Spectral synthesis skips bins this many dB below each frame's loudest; 0 keeps every bin");
+
+    setupHorizontalSlider (morphogenBinsSlider, "Morphogen Partials");
+    morphogenBinsSlider.setDoubleClickReturnValue (true, 0.0);
+    morphogenBinsSlider.setTooltip ("How many partials Morphogen plays, 16 to 4096; 0 picks 48 to 160 from Chaos");
+
+    setupHorizontalSlider (morphogenCellsSlider, "Morphogen Time Cells");
+    morphogenCellsSlider.setDoubleClickReturnValue (true, 0.0);
+    morphogenCellsSlider.setTooltip ("Time cells of Morphogen's reaction-diffusion, 16 to 4096; 0 picks 40 to 420 from Stretch "
+                                     "and Chaos. The plane is held to about two million cells, so past 512 partials it gets fewer");
+
     for (auto* b : { &renderButton, &applyBeautyButton, &exportButton })
     {
         b->setColour (juce::TextButton::buttonColourId, juce::Colour (0xFFC8C8C8));
@@ -136,6 +169,22 @@ MicrosoundSymphonyAudioProcessorEditor::MicrosoundSymphonyAudioProcessorEditor (
         addAndMakeVisible (*b);
     }
 
+    renderProgressBar.setColour (juce::ProgressBar::backgroundColourId, juce::Colour (0xFFBEBEBE));
+    renderProgressBar.setColour (juce::ProgressBar::foregroundColourId, juce::Colour (0xFF8B8B8B));
+    addAndMakeVisible (renderProgressBar);
+
+    profileLabel.setFont (juce::Font (juce::FontOptions (11.0f, juce::Font::plain)));
+    profileLabel.setColour (juce::Label::textColourId, juce::Colour (0xFF3A3A3A));
+    profileLabel.setJustificationType (juce::Justification::topLeft);
+    profileLabel.setMinimumHorizontalScale (0.8f);
+    addAndMakeVisible (profileLabel);
+
+    traceButton.setColour (juce::TextButton::buttonColourId, juce::Colour (0xFFC8C8C8));
+    traceButton.setColour (juce::TextButton::textColourOffId, juce::Colour (0xFF1E1E1E));
+    traceButton.setTooltip ("Save the last render's stage timings as a Chrome / Perfetto trace");
+    traceButton.setEnabled (false);
+    addAndMakeVisible (traceButton);
+
     renderButton.onClick = [this] { audioProcessor.renderNow(); };
     applyBeautyButton.onClick = [this] { audioProcessor.applyBeautyScene(); };
 
@@ -155,10 +204,30 @@ MicrosoundSymphonyAudioProcessorEditor::MicrosoundSymphonyAudioProcessorEditor (
         });
     };
 
+    traceButton.onClick = [this]
+    {
+        exportChooser = std::make_unique<juce::FileChooser> ("Save render trace", juce::File(), "*.json");
+        auto chooserFlags = juce::FileBrowserComponent::saveMode
+                          | juce::FileBrowserComponent::canSelectFiles
+                          | juce::FileBrowserComponent::warnAboutOverwriting;
+
+        exportChooser->launchAsync (chooserFlags, [this] (const juce::FileChooser& chooser)
+        {
+            if (chooser.getResult() != juce::File() && shownProfile != nullptr)
+                shownProfile->writeChromeTrace (chooser.getResult().withFileExtension ("json"));
+
+            exportChooser.reset();
+        });
+    };
+
     auto& apvts = audioProcessor.apvts;
     modeAttachment = std::make_unique<ComboAttachment> (apvts, "mode", modeBox);
     beautySceneAttachment = std::make_unique<ComboAttachment> (apvts, "beautyScene", beautySceneBox);
     microRateAttachment = std::make_unique<ComboAttachment> (apvts, "microRate", microRateBox);
+    fftSizeAttachment = std::make_unique<ComboAttachment> (apvts, "fftSize", fftSizeBox);
+    extendedMicroRateAttachment = std::make_unique<ComboAttachment> (apvts, "extendedMicroRate", extendedMicroRateBox);
+    morphogenSynthAttachment = std::make_unique<ComboAttachment> (apvts, "morphogenSynth", morphogenSynthBox);
+    morphogenFieldAttachment = std::make_unique<ComboAttachment> (apvts, "morphogenField", morphogenFieldBox);
     burstMsAttachment = std::make_unique<SliderAttachment> (apvts, "burstMs", burstMsSlider);
     densityAttachment = std::make_unique<SliderAttachment> (apvts, "density", densitySlider);
     outSecondsAttachment = std::make_unique<SliderAttachment> (apvts, "outSeconds", outSecondsSlider);
@@ -170,12 +239,20 @@ MicrosoundSymphonyAudioProcessorEditor::MicrosoundSymphonyAudioProcessorEditor (
     hybridMixAttachment = std::make_unique<SliderAttachment> (apvts, "hybridMix", hybridMixSlider);
     seedAttachment = std::make_unique<SliderAttachment> (apvts, "seed", seedSlider);
     loopAttachment = std::make_unique<ButtonAttachment> (apvts, "loop", loopButton);
+    playbackRateAttachment = std::make_unique<SliderAttachment> (apvts, "playbackRate", playbackRateSlider);
+    extendedDensityAttachment = std::make_unique<SliderAttachment> (apvts, "extendedDensity", extendedDensitySlider);
+    spectralFloorAttachment = std::make_unique<SliderAttachment> (apvts, "spectralFloor", spectralFloorSlider);
+    morphogenBinsAttachment = std::make_unique<SliderAttachment> (apvts, "morphogenBins", morphogenBinsSlider);
+    morphogenCellsAttachment = std::make_unique<SliderAttachment> (apvts, "morphogenCells", morphogenCellsSlider);
 
     updatePresetColourTheme();
+    timerCallback();
+    startTimerHz (20);
 }
 
 MicrosoundSymphonyAudioProcessorEditor::~MicrosoundSymphonyAudioProcessorEditor()
 {
+    stopTimer();
     presetBox.setLookAndFeel (nullptr);
 }
 
@@ -193,6 +270,19 @@ void MicrosoundSymphonyAudioProcessorEditor::setupSlider (juce::Slider& s, const
     addAndMakeVisible (s);
 }
 
+void MicrosoundSymphonyAudioProcessorEditor::setupHorizontalSlider (juce::Slider& s, const juce::String& name)
+{
+    setupSlider (s, name);
+    s.setSliderStyle (juce::Slider::LinearHorizontal);
+    s.setTextBoxStyle (juce::Slider::TextBoxRight, false, 62, 22);
+}
+
+std::vector<std::vector<juce::Component*>> MicrosoundSymphonyAudioProcessorEditor::getExtendedRows()
+{
+    return { { &extendedMicroRateBox, &extendedDensitySlider, &spectralFloorSlider },
+             { &morphogenSynthBox, &morphogenBinsSlider, &morphogenFieldBox, &morphogenCellsSlider } };
+}
+
 void MicrosoundSymphonyAudioProcessorEditor::updatePresetColourTheme()
 {
     const int idx = presetBox.getSelectedId() - 1;
@@ -205,6 +295,30 @@ void MicrosoundSymphonyAudioProcessorEditor::updatePresetColourTheme()
     repaint (presetBox.getBounds().expanded (6));
 }
 
+void MicrosoundSymphonyAudioProcessorEditor::timerCallback()
+{
+    // The processor publishes render progress through atomics, so this never blocks on the render thread.
+    const auto status = audioProcessor.getRenderStatus();
+    renderProgressValue = status.stage == RenderStage::idle ? 0.0 : (double) status.progress;
+
+    auto text = RenderEngine::getStageName (status.stage);
+    if (status.stage != RenderStage::idle && status.stage != RenderStage::finished)
+        text << " " << juce::roundToInt (status.progress * 100.0f) << "%";
+
+    renderProgressBar.setTextToDisplay (text);
+
+    if (status.stage == RenderStage::finished)
+        renderProgressBar.setTooltip ("Stage cache: " + audioProcessor.getRenderCache().describeLastRender());
+
+    if (auto profile = audioProcessor.getLastRenderProfile(); profile != shownProfile)
+    {
+        shownProfile = std::move (profile);
+        profileLabel.setText (shownProfile->describeStages() + "\n" + shownProfile->describeCounters(), juce::dontSendNotification);
+        profileLabel.setTooltip (profileLabel.getText());
+        traceButton.setEnabled (true);
+    }
+}
+
 void MicrosoundSymphonyAudioProcessorEditor::paint (juce::Graphics& g)
 {
     auto full = getLocalBounds();
@@ -212,6 +326,8 @@ void MicrosoundSymphonyAudioProcessorEditor::paint (juce::Graphics& g)
 
     auto r = full.reduced (12);
     auto hero = r.removeFromTop (82);
+    auto extended = r.removeFromBottom (200);
+    r.removeFromBottom (10);
     auto body = r;
     auto left = body.removeFromLeft (300);
     body.removeFromLeft (10);
@@ -236,11 +352,13 @@ void MicrosoundSymphonyAudioProcessorEditor::paint (juce::Graphics& g)
     drawBevelPanel (leftTop, 12.0f);
     drawBevelPanel (leftBottom, 12.0f);
     drawBevelPanel (body, 12.0f);
+    drawBevelPanel (extended, 12.0f);
 
     g.setColour (juce::Colour (0xFF2D2D2D));
     g.setFont (juce::Font (juce::FontOptions (13.0f, juce::Font::bold)));
     g.drawFittedText ("CONTROL", leftTop.reduced (14, 8).removeFromTop (22), juce::Justification::centredLeft, 1);
     g.drawFittedText ("ACTIONS", leftBottom.reduced (14, 8).removeFromTop (22), juce::Justification::centredLeft, 1);
+    g.drawFittedText ("EXTENDED", extended.reduced (14, 8).removeFromTop (22), juce::Justification::centredLeft, 1);
 
     auto bodyTop = body.reduced (14, 10).removeFromTop (24);
     g.drawFittedText ("STRUCTURE", bodyTop.removeFromLeft (220), juce::Justification::centredLeft, 1);
@@ -252,6 +370,12 @@ void MicrosoundSymphonyAudioProcessorEditor::paint (juce::Graphics& g)
     g.drawFittedText ("Preset", presetBox.getBounds().translated (0, -18), juce::Justification::centredLeft, 1);
     g.drawFittedText ("Beauty Scene", beautySceneBox.getBounds().translated (0, -18), juce::Justification::centredLeft, 1);
     g.drawFittedText ("Micro Rate", microRateBox.getBounds().translated (0, -18), juce::Justification::centredLeft, 1);
+    g.drawFittedText ("FFT Size", fftSizeBox.getBounds().translated (0, -18), juce::Justification::centredLeft, 1);
+    g.drawFittedText ("Speed", playbackRateSlider.getBounds().withWidth (50).translated (-50, 0), juce::Justification::centredLeft, 1);
+
+    for (const auto& row : getExtendedRows())
+        for (auto* c : row)
+            g.drawFittedText (c->getName(), c->getBounds().withY (c->getY() - 18).withHeight (16), juce::Justification::centredLeft, 1);
 
     auto drawName = [&g] (juce::Slider& s)
     {
@@ -280,10 +404,34 @@ void MicrosoundSymphonyAudioProcessorEditor::resized()
     auto area = getLocalBounds().reduced (12);
 
     auto hero = area.removeFromTop (82);
-    titleLabel.setBounds (hero.reduced (18, 10).withHeight (42));
+    auto heroInner = hero.reduced (18, 10);
+    auto status = heroInner.removeFromRight (300);
+    renderProgressBar.setBounds (status.removeFromTop (24));
+    profileLabel.setBounds (status.withTrimmedTop (2));
+    heroInner.removeFromRight (12);
+    traceButton.setBounds (heroInner.removeFromRight (96).withSizeKeepingCentre (96, 24).withY (renderProgressBar.getY()));
+    titleLabel.setBounds (heroInner.withHeight (42));
 
     area.removeFromTop (10);
 
+    // Up to four extended controls to a row, each under its name.
+    auto extended = area.removeFromBottom (200).reduced (14);
+    area.removeFromBottom (10);
+    extended.removeFromTop (26);
+
+    for (const auto& row : getExtendedRows())
+    {
+        auto rowArea = extended.removeFromTop (50).withTrimmedTop (18).withHeight (26);
+        constexpr int gap = 16;
+        const int cellW = (rowArea.getWidth() - gap * 3) / 4;
+
+        for (auto* c : row)
+        {
+            c->setBounds (rowArea.removeFromLeft (cellW));
+            rowArea.removeFromLeft (gap);
+        }
+    }
+
     auto left = area.removeFromLeft (300);
     area.removeFromLeft (10);
     auto right = area;
@@ -296,8 +444,11 @@ void MicrosoundSymphonyAudioProcessorEditor::resized()
     modeBox.setBounds (leftTop.getX(), y, leftTop.getWidth(), 28); y += 46;
     presetBox.setBounds (leftTop.getX(), y, leftTop.getWidth(), 28); y += 46;
     beautySceneBox.setBounds (leftTop.getX(), y, leftTop.getWidth(), 28); y += 46;
-    microRateBox.setBounds (leftTop.getX(), y, leftTop.getWidth(), 28); y += 46;
-    loopButton.setBounds (leftTop.getX(), y, leftTop.getWidth(), 26);
+    const int halfWidth = (leftTop.getWidth() - 10) / 2;
+    microRateBox.setBounds (leftTop.getX(), y, halfWidth, 28);
+    fftSizeBox.setBounds (leftTop.getRight() - halfWidth, y, halfWidth, 28); y += 46;
+    loopButton.setBounds (leftTop.getX(), y, leftTop.getWidth(), 26); y += 30;
+    playbackRateSlider.setBounds (leftTop.getX() + 50, y, leftTop.getWidth() - 50, 26);
 
     auto actionArea = leftBottom.withTrimmedTop (26);
     renderButton.setBounds (actionArea.removeFromTop (40));
@@ -3,7 +3,8 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 
-class MicrosoundSymphonyAudioProcessorEditor : public juce::AudioProcessorEditor
+class MicrosoundSymphonyAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                               private juce::Timer
 {
 public:
     explicit MicrosoundSymphonyAudioProcessorEditor (MicrosoundSymphonyAudioProcessor&);
@@ -21,6 +22,10 @@ private:
     juce::ComboBox presetBox;
     juce::ComboBox beautySceneBox;
     juce::ComboBox microRateBox;
+    juce::ComboBox fftSizeBox;
+    juce::ComboBox extendedMicroRateBox;
+    juce::ComboBox morphogenSynthBox;
+    juce::ComboBox morphogenFieldBox;
     juce::Slider burstMsSlider;
     juce::Slider densitySlider;
     juce::Slider outSecondsSlider;
@@ -32,10 +37,21 @@ private:
     juce::Slider hybridMixSlider;
     juce::Slider seedSlider;
     juce::ToggleButton loopButton { "Loop Playback" };
+    juce::Slider playbackRateSlider;
+    juce::Slider extendedDensitySlider;
+    juce::Slider spectralFloorSlider;
+    juce::Slider morphogenBinsSlider;
+    juce::Slider morphogenCellsSlider;
 
     juce::TextButton renderButton { "Render" };
     juce::TextButton applyBeautyButton { "Apply Beauty" };
     juce::TextButton exportButton { "Export WAV" };
+    double renderProgressValue = 0.0;
+    juce::ProgressBar renderProgressBar { renderProgressValue };
+    juce::Label profileLabel;
+    juce::TextButton traceButton { "Save Trace" };
+    std::shared_ptr<const RenderProfile> shownProfile;
+    juce::TooltipWindow tooltipWindow { this };
     std::unique_ptr<juce::FileChooser> exportChooser;
     std::unique_ptr<juce::LookAndFeel_V4> presetLookAndFeel;
 
@@ -46,6 +62,10 @@ private:
     std::unique_ptr<ComboAttachment> modeAttachment;
     std::unique_ptr<ComboAttachment> beautySceneAttachment;
     std::unique_ptr<ComboAttachment> microRateAttachment;
+    std::unique_ptr<ComboAttachment> fftSizeAttachment;
+    std::unique_ptr<ComboAttachment> extendedMicroRateAttachment;
+    std::unique_ptr<ComboAttachment> morphogenSynthAttachment;
+    std::unique_ptr<ComboAttachment> morphogenFieldAttachment;
     std::unique_ptr<SliderAttachment> burstMsAttachment;
     std::unique_ptr<SliderAttachment> densityAttachment;
     std::unique_ptr<SliderAttachment> outSecondsAttachment;
@@ -57,9 +77,21 @@ private:
     std::unique_ptr<SliderAttachment> hybridMixAttachment;
     std::unique_ptr<SliderAttachment> seedAttachment;
     std::unique_ptr<ButtonAttachment> loopAttachment;
+    std::unique_ptr<SliderAttachment> playbackRateAttachment;
+    std::unique_ptr<SliderAttachment> extendedDensityAttachment;
+    std::unique_ptr<SliderAttachment> spectralFloorAttachment;
+    std::unique_ptr<SliderAttachment> morphogenBinsAttachment;
+    std::unique_ptr<SliderAttachment> morphogenCellsAttachment;
 
     void setupSlider (juce::Slider& s, const juce::String& name);
+    void setupHorizontalSlider (juce::Slider& s, const juce::String& name);
+
+    // The controls of parameters appended after the original ones, by row of the EXTENDED panel.
+    // Each is drawn with its component name above it.
+    std::vector<std::vector<juce::Component*>> getExtendedRows();
+
     void updatePresetColourTheme();
+    void timerCallback() override;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MicrosoundSymphonyAudioProcessorEditor)
 };
@@ -1,12 +1,33 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "RenderEngine.h"
+#include <array>
+#include <atomic>
 
-class MicrosoundSymphonyAudioProcessor : public juce::AudioProcessor
+// A finished render. Immutable once published, so playback and export can share it without copying.
+class RenderedAudio : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<RenderedAudio>;
+
+    RenderedAudio (juce::AudioBuffer<float>&& bufferIn, double sampleRateIn)
+        : buffer (std::move (bufferIn)), sampleRate (sampleRateIn)
+    {}
+
+    const juce::AudioBuffer<float> buffer;
+    const double sampleRate;
+
+private:
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderedAudio)
+};
+
+class MicrosoundSymphonyAudioProcessor : public juce::AudioProcessor,
+                                         private juce::Timer
 {
 public:
     MicrosoundSymphonyAudioProcessor();
-    ~MicrosoundSymphonyAudioProcessor() override = default;
+    ~MicrosoundSymphonyAudioProcessor() override;
 
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -31,7 +52,19 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    struct RenderStatus
+    {
+        RenderStage stage = RenderStage::idle;
+        float progress = 0.0f;
+    };
+
     void renderNow();
+    RenderRequest makeRenderRequest() const;
+    RenderStatus getRenderStatus() const noexcept;
+    RenderedAudio::Ptr getLastRender() const;
+    std::shared_ptr<const RenderProfile> getLastRenderProfile() const;
+    const RenderCache& getRenderCache() const noexcept { return renderCache; }
+
     void applyBeautyScene();
     void applyPreset (int presetIndex);
     static juce::StringArray getPresetNames();
@@ -42,70 +75,58 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
 private:
-    juce::AudioBuffer<float> renderMicroBurst (double microRate, double burstMs, int density) const;
-    juce::AudioBuffer<float> unfoldGranular (const juce::AudioBuffer<float>& micro,
-                                             double microRate,
-                                             double outRate,
-                                             double outSeconds,
-                                             float grainOutMs,
-                                             float overlap,
-                                             int seed) const;
-
-    juce::AudioBuffer<float> unfoldSpectral (const juce::AudioBuffer<float>& micro,
-                                             double microRate,
-                                             double outRate,
-                                             double outSeconds,
-                                             float stretch,
-                                             float spectralWarp,
-                                             float spectralChaos,
-                                             int seed) const;
-    juce::AudioBuffer<float> unfoldMorphogen (const juce::AudioBuffer<float>& micro,
-                                              double microRate,
-                                              double outRate,
-                                              double outSeconds,
-                                              float stretch,
-                                              float spectralWarp,
-                                              float spectralChaos,
-                                              float hybridMix,
-                                              int seed) const;
-    juce::AudioBuffer<float> unfoldFennesz (const juce::AudioBuffer<float>& micro,
-                                            double microRate,
-                                            double outRate,
-                                            double outSeconds,
-                                            float stretch,
-                                            float spectralWarp,
-                                            float spectralChaos,
-                                            float hybridMix,
-                                            int seed) const;
-    juce::AudioBuffer<float> unfoldNoto (const juce::AudioBuffer<float>& micro,
-                                         double microRate,
-                                         double outRate,
-                                         double outSeconds,
-                                         float stretch,
-                                         float spectralWarp,
-                                         float spectralChaos,
-                                         int seed) const;
-    juce::AudioBuffer<float> unfoldIkeda (const juce::AudioBuffer<float>& micro,
-                                          double microRate,
-                                          double outRate,
-                                          double outSeconds,
-                                          float stretch,
-                                          float spectralWarp,
-                                          float spectralChaos,
-                                          int seed) const;
-
-    static juce::AudioBuffer<float> toMono (const juce::AudioBuffer<float>& in);
     void setParameterValue (const juce::String& paramID, float plainValue);
-    static float princArg (float x);
-    static void sanitizeBufferInPlace (juce::AudioBuffer<float>& b);
-    static void applyBloomInPlace (juce::AudioBuffer<float>& b, double sampleRate, int seed, float amount);
-    static void normalizeInPlace (juce::AudioBuffer<float>& b, float peakTarget = 0.95f);
 
-    juce::CriticalSection renderedLock;
-    juce::AudioBuffer<float> renderedBuffer;
+    class RenderJob;
+    void publishRender (juce::AudioBuffer<float>&& rendered, double sampleRate, juce::uint32 generation,
+                        std::shared_ptr<const RenderProfile> profile);
+    bool pushRetired (RenderedAudio* render) noexcept;
+    void retireFromAudioThread (RenderedAudio* render) noexcept;
+    void reclaimRetiredRenders();
+    void timerCallback() override;
+
+    // Message/render-thread side: the most recent render, for export. Never touched by processBlock.
+    juce::CriticalSection lastRenderLock;
+    RenderedAudio::Ptr lastRender;
+    std::shared_ptr<const RenderProfile> lastProfile;
+
+    // Hand-off to the audio thread. Each pointer here carries one manual reference that the
+    // audio thread gives back through retiredRenders once it has stopped reading the render.
+    std::atomic<RenderedAudio*> pendingRender { nullptr };
+    static constexpr int retiredCapacity = 64;
+    juce::AbstractFifo retiredFifo { retiredCapacity };
+    std::array<RenderedAudio*, (size_t) retiredCapacity> retiredRenders {};
+    juce::CriticalSection reclaimLock;
+
+    // Audio-thread only.
+    struct PlaybackVoice
+    {
+        RenderedAudio* render = nullptr;
+        int cursor = 0;
+        double fraction = 0.0; // sub-sample read offset, only non-zero during varispeed playback
+        bool finished = false; // ran off either end with Loop off; silent until Loop is turned on
+    };
+
+    static void addVoiceToBuffer (PlaybackVoice& voice, juce::AudioBuffer<float>& dest, int destStart, int numSamples,
+                                  float gainStart, float gainEnd, bool loop, double rate) noexcept;
+
+    PlaybackVoice playingVoice;
+    PlaybackVoice fadingVoice;
+    int fadePosition = 0;
+    int fadeLength = 0;
+    RenderedAudio* retiredOverflow = nullptr; // turned away by a full retiredFifo, still owned here
 
     double hostSampleRate = 44100.0;
-    int playbackCursor = 0;
+
+    RenderCache renderCache { 2 };
+    juce::SharedResourcePointer<RenderWorkerPool> workerPool;
+    const RenderEngine engine { &renderCache, &workerPool->pool };
+    std::atomic<juce::uint32> renderGeneration { 0 };
+    std::atomic<int> renderStage { (int) RenderStage::idle };
+    std::atomic<float> renderProgress { 0.0f };
+
+    // Declared last so it is torn down (and its running job stopped) before anything the job touches.
+    juce::ThreadPool renderPool { 1 };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MicrosoundSymphonyAudioProcessor)
 };
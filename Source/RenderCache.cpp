@@ -0,0 +1,146 @@
+#include "RenderCache.h"
+
+RenderCache::RenderCache (int entriesPerStageIn)
+    : entriesPerStage (juce::jmax (1, entriesPerStageIn))
+{
+}
+
+RenderCache::Buffer RenderCache::find (Stage stage, juce::uint64 key)
+{
+    jassert (stage != Stage::microEvents);
+    return findEntry (stage, key).buffer;
+}
+
+void RenderCache::store (Stage stage, juce::uint64 key, Buffer buffer)
+{
+    jassert (stage != Stage::microEvents);
+    if (buffer != nullptr)
+        storeEntry (stage, { key, std::move (buffer), {}, 0 });
+}
+
+RenderCache::Events RenderCache::findEvents (juce::uint64 key)
+{
+    return findEntry (Stage::microEvents, key).events;
+}
+
+void RenderCache::storeEvents (juce::uint64 key, Events events)
+{
+    if (events != nullptr)
+        storeEntry (Stage::microEvents, { key, {}, std::move (events), 0 });
+}
+
+RenderCache::Entry RenderCache::findEntry (Stage stage, juce::uint64 key)
+{
+    auto& c = counters[(size_t) stage];
+
+    {
+        const juce::ScopedLock sl (lock);
+        for (auto& e : entries[(size_t) stage])
+        {
+            if (e.key == key)
+            {
+                e.lastUsed = ++useClock;
+                ++c.lastHits;
+                ++c.totalHits;
+                return e;
+            }
+        }
+    }
+
+    ++c.lastMisses;
+    ++c.totalMisses;
+    return {};
+}
+
+void RenderCache::storeEntry (Stage stage, Entry entry)
+{
+    const juce::ScopedLock sl (lock);
+    auto& list = entries[(size_t) stage];
+    entry.lastUsed = ++useClock;
+
+    for (auto& e : list)
+    {
+        if (e.key == entry.key)
+        {
+            e = std::move (entry);
+            return;
+        }
+    }
+
+    if ((int) list.size() >= entriesPerStage)
+    {
+        // Evict the least recently used entry for this stage.
+        auto oldest = std::min_element (list.begin(), list.end(),
+                                        [] (const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+        list.erase (oldest);
+    }
+
+    list.push_back (std::move (entry));
+}
+
+void RenderCache::clear()
+{
+    const juce::ScopedLock sl (lock);
+    for (auto& list : entries)
+        list.clear();
+}
+
+void RenderCache::beginRender()
+{
+    for (auto& c : counters)
+    {
+        c.lastHits = 0;
+        c.lastMisses = 0;
+    }
+}
+
+RenderCache::StageStats RenderCache::getLastRenderStats (Stage stage) const noexcept
+{
+    const auto& c = counters[(size_t) stage];
+    return { c.lastHits.load(), c.lastMisses.load() };
+}
+
+RenderCache::StageStats RenderCache::getTotalStats (Stage stage) const noexcept
+{
+    const auto& c = counters[(size_t) stage];
+    return { c.totalHits.load(), c.totalMisses.load() };
+}
+
+juce::String RenderCache::describeLastRender() const
+{
+    juce::StringArray parts;
+
+    for (size_t i = 0; i < numStages; ++i)
+    {
+        const auto stats = getLastRenderStats ((Stage) i);
+        if (stats.hits + stats.misses == 0)
+            continue;
+
+        parts.add (getStageName ((Stage) i) + ": "
+                   + juce::String (stats.hits) + " hit / " + juce::String (stats.misses) + " miss");
+    }
+
+    return parts.joinIntoString (", ");
+}
+
+juce::String RenderCache::getStageName (Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::microEvents:      return "micro events";
+        case Stage::microBurst:       return "micro burst";
+        case Stage::microTap:         return "micro tap";
+        case Stage::spectralAnalysis: return "spectral analysis";
+        case Stage::spectral:         return "spectral";
+        case Stage::granular:         return "granular";
+        case Stage::xeno:             return "xeno";
+        case Stage::morphogen:        return "morphogen";
+        case Stage::fennesz:          return "fennesz";
+        case Stage::noto:             return "noto";
+        case Stage::ikeda:            return "ikeda";
+        case Stage::finish:           return "bloom/normalize";
+        case Stage::numStages:        break;
+    }
+
+    return {};
+}
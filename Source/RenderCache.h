@@ -0,0 +1,124 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+struct MicroEventTable;
+
+// Builds a 64-bit key for a render stage from everything that stage reads.
+// Upstream stage keys are folded in, so a key changes whenever any input further up the graph does.
+class StageKey
+{
+public:
+    StageKey& add (juce::uint64 v) noexcept
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            hash ^= (v >> (8 * i)) & 0xffu;
+            hash *= 1099511628211ull;
+        }
+        return *this;
+    }
+
+    StageKey& add (int v) noexcept     { return add ((juce::uint64) (juce::uint32) v); }
+    StageKey& add (float v) noexcept   { juce::uint32 bits; std::memcpy (&bits, &v, sizeof (bits)); return add ((juce::uint64) bits); }
+    StageKey& add (double v) noexcept  { juce::uint64 bits; std::memcpy (&bits, &v, sizeof (bits)); return add (bits); }
+
+    // Folds in a block of samples a word at a time, for stages keyed by the buffer they were given
+    // rather than by the parameters that produced it.
+    StageKey& add (const float* samples, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            juce::uint32 bits;
+            std::memcpy (&bits, samples + i, sizeof (bits));
+            hash = (hash ^ bits) * 1099511628211ull;
+        }
+        return add (numSamples);
+    }
+
+    juce::uint64 get() const noexcept { return hash; }
+
+private:
+    juce::uint64 hash = 14695981039346656037ull;
+};
+
+// In-memory memo of render stage outputs, so a parameter tweak only recomputes the stages it reaches.
+// Thread-safe; entries are immutable and shared, so a hit never copies.
+class RenderCache
+{
+public:
+    enum class Stage
+    {
+        microEvents,
+        microBurst,
+        microTap,
+        spectralAnalysis,
+        spectral,
+        granular,
+        xeno,
+        morphogen,
+        fennesz,
+        noto,
+        ikeda,
+        finish,
+        numStages
+    };
+
+    using Buffer = std::shared_ptr<const juce::AudioBuffer<float>>;
+    using Events = std::shared_ptr<const MicroEventTable>;
+
+    struct StageStats
+    {
+        int hits = 0;
+        int misses = 0;
+    };
+
+    explicit RenderCache (int entriesPerStage = 4);
+
+    Buffer find (Stage stage, juce::uint64 key);
+    void store (Stage stage, juce::uint64 key, Buffer buffer);
+    void clear();
+
+    // The microEvents stage holds event tables rather than buffers.
+    Events findEvents (juce::uint64 key);
+    void storeEvents (juce::uint64 key, Events events);
+
+    // Counters for the render currently (or most recently) in progress, and since construction.
+    void beginRender();
+    StageStats getLastRenderStats (Stage stage) const noexcept;
+    StageStats getTotalStats (Stage stage) const noexcept;
+    juce::String describeLastRender() const;
+
+    static juce::String getStageName (Stage stage);
+
+private:
+    struct Entry
+    {
+        juce::uint64 key = 0;
+        Buffer buffer;
+        Events events;
+        juce::uint64 lastUsed = 0;
+    };
+
+    Entry findEntry (Stage stage, juce::uint64 key);
+    void storeEntry (Stage stage, Entry entry);
+
+    struct Counters
+    {
+        std::atomic<int> lastHits { 0 }, lastMisses { 0 }, totalHits { 0 }, totalMisses { 0 };
+    };
+
+    static constexpr size_t numStages = (size_t) Stage::numStages;
+
+    const int entriesPerStage;
+    mutable juce::CriticalSection lock;
+    std::array<std::vector<Entry>, numStages> entries;
+    std::array<Counters, numStages> counters;
+    juce::uint64 useClock = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderCache)
+};
@@ -0,0 +1,2957 @@
+#include "RenderEngine.h"
+#include "Decimator.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+using FastMath::fastTanh;
+
+// The exact-math build renders with libm in place of the approximations (see FastMath.h).
+#if MICROSOUND_EXACT_MATH
+inline float sinTurns (double turns) noexcept      { return FastMath::exactSinTurns (turns); }
+inline float fastAtan2 (float y, float x) noexcept { return FastMath::exactAtan2 (y, x); }
+inline float fastExp (float x) noexcept            { return FastMath::exactExp (x); }
+inline float wrapPhase (float x) noexcept          { return FastMath::exactWrapPhase (x); }
+#else
+using FastMath::sinTurns;
+using FastMath::fastAtan2;
+using FastMath::fastExp;
+using FastMath::wrapPhase;
+#endif
+
+int popcount32 (uint32_t v)
+{
+    int c = 0;
+    while (v != 0u)
+    {
+        v &= (v - 1u);
+        ++c;
+    }
+    return c;
+}
+
+const std::array<RenderPreset, 51>& getPresetBank()
+{
+    static const std::array<RenderPreset, 51> bank {{
+        { "Porcelain Air", 1, 0, 6.5f, 2800, 3.6f, 8.0f, 1.9f, 14.0f, 5.6f, 0.08f, 0.04f, 1101, 0 },
+        { "Tape Halo", 4, 1, 26.0f, 7400, 9.0f, 62.0f, 7.4f, 22.0f, 1.2f, 0.28f, 0.64f, 2202, 1 },
+        { "Star Fracture", 3, 3, 9.0f, 7000, 5.6f, 12.0f, 2.4f, 74.0f, 5.6f, 0.98f, 0.08f, 3303, 2 },
+        { "Coal Cathedral", 2, 2, 62.0f, 24000, 18.0f, 150.0f, 15.8f, 52.0f, 1.4f, 0.88f, 0.93f, 4404, 3 },
+        { "Needle Rain", 0, 3, 16.0f, 5400, 7.2f, 22.0f, 4.2f, 14.0f, 2.5f, 0.36f, 0.30f, 5505, 0 },
+        { "Salt Bells", 1, 2, 8.4f, 3900, 4.4f, 9.0f, 2.1f, 64.0f, 5.8f, 0.86f, 0.03f, 6606, 2 },
+        { "Moss Choir", 4, 1, 44.0f, 11800, 13.5f, 102.0f, 12.4f, 30.0f, 1.6f, 0.54f, 0.82f, 7707, 1 },
+        { "Rust Sparks", 3, 1, 26.0f, 18600, 9.8f, 26.0f, 6.8f, 18.0f, 1.4f, 0.67f, 0.62f, 8808, 0 },
+        { "Frozen Organ", 2, 3, 36.0f, 15000, 12.0f, 66.0f, 8.9f, 40.0f, 2.9f, 0.73f, 0.69f, 9909, 3 },
+        { "Paper Wind", 0, 0, 30.0f, 4100, 10.0f, 86.0f, 10.5f, 10.0f, 1.0f, 0.18f, 0.42f, 1110, 0 },
+        { "Chrome Bloom", 1, 2, 14.0f, 8200, 7.5f, 16.0f, 3.3f, 50.0f, 3.9f, 0.67f, 0.11f, 1212, 2 },
+        { "Velour Sea", 2, 2, 52.0f, 10400, 15.2f, 128.0f, 14.0f, 24.0f, 1.1f, 0.33f, 0.89f, 1313, 1 },
+        { "Glitch Psalms", 3, 3, 31.0f, 28000, 12.2f, 34.0f, 4.2f, 92.0f, 3.0f, 1.00f, 0.12f, 1414, 3 },
+        { "Ivory Mist", 4, 1, 18.0f, 5800, 8.8f, 20.0f, 3.8f, 28.0f, 2.1f, 0.31f, 0.18f, 1515, 0 },
+        { "Tin Jungle", 0, 2, 28.0f, 17000, 11.0f, 40.0f, 6.0f, 12.0f, 2.2f, 0.62f, 0.38f, 1616, 0 },
+        { "Night Plume", 2, 1, 58.0f, 19600, 17.0f, 140.0f, 15.4f, 36.0f, 1.9f, 0.77f, 0.87f, 1717, 3 },
+        { "Opal Threads", 4, 2, 14.0f, 6200, 10.8f, 30.0f, 4.4f, 36.0f, 2.8f, 0.55f, 0.24f, 1818, 2 },
+        { "Sunken Choir", 4, 0, 48.0f, 9000, 14.6f, 116.0f, 13.2f, 20.0f, 1.3f, 0.42f, 0.84f, 1919, 1 },
+        { "Quartz Static", 3, 3, 6.0f, 3000, 4.2f, 10.0f, 1.8f, 54.0f, 6.0f, 0.90f, 0.02f, 2020, 0 },
+        { "Monolith Flood", 2, 2, 64.0f, 28000, 19.5f, 160.0f, 16.0f, 56.0f, 2.2f, 1.00f, 0.95f, 2121, 3 },
+
+        { "Glass Drizzle", 1, 0, 5.4f, 1800, 2.1f, 8.0f, 1.6f, 32.0f, 5.9f, 0.22f, 0.03f, 2301, 2 },
+        { "Abyss Lantern", 4, 3, 72.0f, 25000, 20.0f, 174.0f, 16.0f, 58.0f, 0.9f, 0.71f, 0.91f, 2402, 3 },
+        { "Helix Dust", 3, 0, 11.0f, 6200, 6.9f, 58.0f, 13.0f, 12.0f, 0.7f, 0.41f, 0.93f, 2503, 0 },
+        { "Ion Choir", 2, 3, 41.0f, 9000, 16.3f, 132.0f, 15.0f, 18.0f, 1.0f, 0.26f, 0.98f, 2604, 1 },
+        { "Broken Neutrino", 1, 3, 7.2f, 24000, 5.0f, 8.5f, 1.7f, 96.0f, 4.9f, 0.97f, 0.01f, 2705, 0 },
+        { "Pollen Array", 0, 1, 22.0f, 9500, 8.2f, 26.0f, 3.3f, 6.0f, 3.1f, 0.52f, 0.21f, 2806, 0 },
+        { "Silt Harmonics", 4, 2, 31.0f, 6800, 12.7f, 92.0f, 9.9f, 44.0f, 2.8f, 0.63f, 0.27f, 2907, 2 },
+        { "Razor Kelp", 3, 1, 14.0f, 21000, 7.1f, 16.0f, 2.1f, 84.0f, 5.7f, 0.99f, 0.06f, 3008, 3 },
+        { "Cathedral Frost", 2, 0, 80.0f, 5000, 19.0f, 180.0f, 16.0f, 8.0f, 0.6f, 0.11f, 0.99f, 3109, 1 },
+        { "Grit Orbit", 0, 3, 13.0f, 26000, 6.5f, 14.0f, 2.0f, 4.0f, 4.7f, 0.83f, 0.12f, 3210, 0 },
+
+        { "Coastal Melt", 5, 1, 46.0f, 9000, 14.0f, 118.0f, 12.8f, 24.0f, 1.4f, 0.32f, 0.82f, 3301, 1 },
+        { "Burning Tape Sky", 5, 2, 58.0f, 13000, 17.2f, 146.0f, 14.6f, 30.0f, 1.1f, 0.58f, 0.91f, 3302, 3 },
+        { "Soft Rust Choir", 5, 0, 34.0f, 7000, 11.8f, 96.0f, 10.2f, 18.0f, 1.7f, 0.24f, 0.73f, 3303, 1 },
+        { "Solar Foam", 5, 3, 22.0f, 5400, 9.6f, 68.0f, 7.0f, 42.0f, 2.2f, 0.49f, 0.64f, 3304, 2 },
+        { "Velvet Collapse", 5, 2, 64.0f, 18000, 20.0f, 172.0f, 16.0f, 54.0f, 0.9f, 0.77f, 0.95f, 3305, 3 },
+
+        { "Pulse Lattice A", 6, 3, 8.0f, 12000, 6.0f, 12.0f, 2.2f, 48.0f, 4.0f, 0.68f, 0.08f, 3401, 0 },
+        { "Pulse Lattice B", 6, 1, 10.0f, 9000, 7.4f, 16.0f, 3.0f, 22.0f, 2.0f, 0.42f, 0.06f, 3402, 0 },
+        { "Sparse Click Field", 6, 0, 6.2f, 3500, 5.2f, 8.0f, 1.6f, 14.0f, 5.2f, 0.21f, 0.03f, 3403, 0 },
+        { "Grid Failure", 6, 2, 12.0f, 20000, 8.8f, 20.0f, 3.4f, 70.0f, 3.6f, 0.92f, 0.15f, 3404, 3 },
+        { "Binary Rain", 6, 3, 16.0f, 26000, 10.2f, 24.0f, 3.8f, 84.0f, 2.8f, 1.00f, 0.18f, 3405, 3 },
+
+        { "Data Monolith", 7, 3, 7.0f, 5000, 6.6f, 10.0f, 2.0f, 40.0f, 5.6f, 0.84f, 0.02f, 3501, 0 },
+        { "White Vector", 7, 2, 5.8f, 2800, 4.1f, 8.0f, 1.4f, 18.0f, 6.0f, 0.16f, 0.01f, 3502, 0 },
+        { "Quantized Beam", 7, 1, 9.4f, 4600, 5.8f, 10.0f, 1.8f, 28.0f, 4.9f, 0.33f, 0.02f, 3503, 2 },
+        { "Telemetry Storm", 7, 3, 14.0f, 14000, 9.4f, 18.0f, 2.9f, 76.0f, 3.1f, 0.96f, 0.05f, 3504, 3 },
+        { "Atomic Corridor", 7, 0, 11.0f, 8000, 8.0f, 14.0f, 2.2f, 52.0f, 3.8f, 0.59f, 0.03f, 3505, 2 },
+
+        { "Diskont Crackle Grid", 6, 2, 12.5f, 22000, 9.0f, 16.0f, 2.6f, 78.0f, 3.8f, 0.94f, 0.09f, 3601, 3 },
+        { "Diskont Skipping Plate", 3, 1, 18.0f, 17000, 10.5f, 22.0f, 3.2f, 66.0f, 4.6f, 0.97f, 0.12f, 3602, 3 },
+        { "Diskont Data Erosion", 7, 3, 9.0f, 12000, 8.4f, 14.0f, 2.4f, 58.0f, 4.9f, 0.88f, 0.04f, 3603, 0 },
+
+        { "Ovalcommers Soft Mosaic", 2, 2, 29.0f, 11200, 13.8f, 76.0f, 9.6f, 34.0f, 2.7f, 0.56f, 0.72f, 3611, 2 },
+        { "Ovalcommers Bloom Skip", 5, 2, 32.0f, 9400, 13.8f, 62.0f, 8.2f, 28.0f, 1.9f, 0.41f, 0.66f, 3612, 1 },
+        { "Ovalcommers Neon Drift", 2, 1, 24.0f, 8600, 11.6f, 56.0f, 7.0f, 22.0f, 2.2f, 0.52f, 0.72f, 3613, 1 }
+    }};
+    return bank;
+}
+
+bool isCancelled (const RenderMonitor* monitor)
+{
+    return monitor != nullptr && monitor->shouldCancel();
+}
+
+RenderProfile* profileOf (const RenderMonitor* monitor)
+{
+    return monitor != nullptr ? monitor->getProfile() : nullptr;
+}
+
+// Micro bursts are synthesized in time tiles of this many samples, small enough that a tile and the
+// tails of its events stay in cache.
+constexpr int microTileSamples = 8192;
+
+// Granular clouds are rendered in output tiles of this many samples, one task per tile.
+constexpr int granularTileSamples = 16384;
+
+inline int maxMicroEventLength (double microRate) noexcept
+{
+    return juce::jmax (8, (int) (0.0012 * microRate));
+}
+
+// Seed of event `index`'s own random stream (a splitmix64 step), so nearby events don't correlate.
+inline juce::int64 eventSeed (juce::int64 streamSeed, int index) noexcept
+{
+    auto z = (juce::uint64) streamSeed + (juce::uint64) (index + 1) * 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return (juce::int64) (z ^ (z >> 31));
+}
+
+// Brings a non-negative phase (in turns) back into [0, 1).
+inline double wrapTurns (double turns) noexcept
+{
+    return turns - (double) (int) turns;
+}
+
+// Hann window and read curves u^e for one grain length, built once and shared between renders.
+// Curves are tabulated for evenly spaced exponents; a grain takes the one below its own exponent
+// and corrects it by u^d = exp (d ln u), which for the small d left over is a short series.
+struct GrainShapes
+{
+    static constexpr int numCurves = 32;
+    static constexpr float minExponent = 0.30f, maxExponent = 0.94f;
+
+    explicit GrainShapes (int lengthIn)
+        : length (lengthIn), window ((size_t) lengthIn), logU ((size_t) lengthIn), curves ((size_t) (numCurves * lengthIn))
+    {
+        const auto invLen = 1.0 / juce::jmax (1, length - 1);
+
+        for (int i = 0; i < length; ++i)
+        {
+            const auto u = i * invLen;
+            window[(size_t) i] = (float) (0.5 - 0.5 * std::cos (juce::MathConstants<double>::twoPi * u));
+            logU[(size_t) i] = i > 0 ? (float) std::log (u) : 0.0f; // u^e is 0 there whatever the correction
+
+            for (int c = 0; c < numCurves; ++c)
+                curves[(size_t) (c * length + i)] = (float) std::pow (u, getExponent (c));
+        }
+    }
+
+    static double getExponent (int curve) noexcept
+    {
+        return minExponent + (maxExponent - minExponent) * curve / numCurves;
+    }
+
+    static std::shared_ptr<const GrainShapes> get (int length)
+    {
+        static juce::CriticalSection lock;
+        static std::vector<std::shared_ptr<const GrainShapes>> recent;
+
+        const juce::ScopedLock sl (lock);
+
+        for (auto& shapes : recent)
+            if (shapes->length == length)
+                return shapes;
+
+        if (recent.size() >= 4)
+            recent.erase (recent.begin());
+
+        recent.push_back (std::make_shared<const GrainShapes> (length));
+        return recent.back();
+    }
+
+    const int length;
+    std::vector<float> window, logU, curves;
+};
+
+// Everything about one grain that stays fixed while it plays.
+struct Grain
+{
+    int outPos = 0;
+    int srcStart = 0;
+    float readSpan = 0.0f;      // micro samples covered by the whole read curve
+    int level = 0;              // read from the burst decimated by 2^level (see makeGrainSources)
+    float exponent = 0.62f;     // of the read curve
+    bool reverse = false;
+    float leftGain = 0.0f, rightGain = 0.0f;
+    float drive = 1.0f;         // into the tanh
+    float lfoCycles = 1.5f;     // over the grain
+};
+
+// The grain read step, in micro samples per output sample, past which a grain reads the burst
+// decimated by 2^level: about one sample of it per output sample, so whatever it transposes up
+// stays under the host Nyquist.
+int getGrainLevel (float readStep) noexcept
+{
+    return readStep <= 1.0f ? 0 : (int) std::ceil (std::log2 (readStep));
+}
+
+// The burst decimated to microRate / 2^level for each level above 0 that a grain reads from; the
+// others, and level 0 (the burst itself), are left empty.
+std::vector<juce::AudioBuffer<float>> makeGrainSources (const juce::AudioBuffer<float>& micro, double microRate,
+                                                        const std::vector<Grain>& grains, RenderProfile* profile,
+                                                        const RenderMonitor* monitor)
+{
+    int numLevels = 1;
+    for (const auto& g : grains)
+        numLevels = juce::jmax (numLevels, g.level + 1);
+
+    std::vector<bool> used ((size_t) numLevels, false);
+    for (const auto& g : grains)
+        used[(size_t) g.level] = true;
+
+    std::vector<juce::AudioBuffer<float>> sources ((size_t) numLevels);
+    const RenderProfile::ScopedSpan span (profile, "grain sources");
+
+    for (int level = 1; level < numLevels; ++level)
+    {
+        if (! used[(size_t) level])
+            continue;
+
+        if (isCancelled (monitor))
+            break;
+
+        const auto rate = microRate / (double) (1 << level);
+        const auto decimator = Decimator::get (microRate, rate);
+        auto& source = sources[(size_t) level];
+        source.setSize (micro.getNumChannels(), (micro.getNumSamples() >> level) + 1);
+
+        for (int ch = 0; ch < micro.getNumChannels(); ++ch)
+            decimator->process (micro.getReadPointer (ch), micro.getNumSamples(), source.getWritePointer (ch), source.getNumSamples());
+
+        RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated, (juce::int64) sizeof (float) * source.getNumChannels() * source.getNumSamples());
+    }
+
+    return sources;
+}
+
+// Adds one grain to target, whose first sample is output sample targetStart, in blocks: a scalar
+// pass gathers and interpolates the grain's source (the burst or a decimated copy of it) along the
+// read curve, then a vectorizable pass shapes, windows and pans the block. The grain is cut off at
+// totalSamples.
+void renderGrain (const GrainShapes& shapes, const Grain& g, const juce::AudioBuffer<float>& micro,
+                  const std::vector<juce::AudioBuffer<float>>& decimated, juce::AudioBuffer<float>& target,
+                  int targetStart, int totalSamples)
+{
+    constexpr int blockSize = 256;
+
+    const auto& source = g.level > 0 ? decimated[(size_t) g.level] : micro;
+    const float scale = 1.0f / (float) (1 << g.level);   // micro samples to source samples
+    const int len = juce::jmin (shapes.length, totalSamples - g.outPos);
+    const int microSamples = source.getNumSamples();
+    const float* inL = source.getReadPointer (0);
+    const float* inR = source.getReadPointer (1);
+    float* outL = target.getWritePointer (0, g.outPos - targetStart);
+    float* outR = target.getWritePointer (1, g.outPos - targetStart);
+
+    const auto curvePos = (g.exponent - GrainShapes::minExponent) / (GrainShapes::maxExponent - GrainShapes::minExponent) * GrainShapes::numCurves;
+    const int c = juce::jlimit (0, GrainShapes::numCurves - 1, (int) curvePos);
+    const auto delta = (float) (g.exponent - GrainShapes::getExponent (c));
+    const float* curve = shapes.curves.data() + c * shapes.length;
+    const float* logU = shapes.logU.data();
+    const float* window = shapes.window.data();
+    const float invLen = 1.0f / (float) juce::jmax (1, shapes.length - 1);
+
+    float airy[blockSize];
+
+    for (int blockStart = 0; blockStart < len; blockStart += blockSize)
+    {
+        const int n = juce::jmin (blockSize, len - blockStart);
+
+        for (int j = 0; j < n; ++j)
+        {
+            const int i = blockStart + j;
+            const int k = g.reverse ? shapes.length - 1 - i : i;
+            const float x = delta * logU[k];
+            const float shaped = curve[k] * (1.0f + x * (1.0f + x * (0.5f + x * (1.0f / 6.0f + x * (1.0f / 24.0f)))));
+            const float readPos = ((float) g.srcStart + shaped * g.readSpan) * scale;
+            const int r0 = juce::jlimit (0, microSamples - 1, (int) readPos);
+            const int r1 = juce::jmin (microSamples - 1, r0 + 1);
+            const float frac = readPos - (float) r0;
+            const float sL = inL[r0] + frac * (inL[r1] - inL[r0]);
+            const float sR = inR[r0] + frac * (inR[r1] - inR[r0]);
+            airy[j] = 0.325f * (sL + sR) + 0.35f * (sL - sR);
+        }
+
+        for (int j = 0; j < n; ++j)
+        {
+            const int i = blockStart + j;
+            const float lfo = 0.55f + 0.45f * sinTurns ((double) ((float) i * invLen * g.lfoCycles));
+            const float s = fastTanh (g.drive * airy[j]) * window[i];
+            outL[i] += s * g.leftGain * lfo;
+            outR[i] += s * g.rightGain * (2.0f - lfo);
+        }
+    }
+}
+
+// An FFT of one order plus its Hann window, shared process-wide so that repeated spectral unfolds
+// do not rebuild them.
+struct FFTPlan
+{
+    static constexpr int maxOrder = 15;
+
+    explicit FFTPlan (int orderIn)
+        : order (orderIn), size (1 << orderIn), window ((size_t) size)
+    {
+        for (int n = 0; n < size; ++n)
+            window[(size_t) n] = 0.5f - 0.5f * std::cos (twoPi * (float) n / (float) juce::jmax (1, size - 1));
+    }
+
+    static std::shared_ptr<const FFTPlan> get (int order)
+    {
+        jassert (order >= 0 && order <= maxOrder);
+
+        static juce::CriticalSection lock;
+        static std::array<std::shared_ptr<const FFTPlan>, maxOrder + 1> plans;
+
+        const juce::ScopedLock sl (lock);
+        auto& plan = plans[(size_t) juce::jlimit (0, maxOrder, order)];
+
+        if (plan == nullptr)
+            plan = std::make_shared<const FFTPlan> (order);
+
+        return plan;
+    }
+
+    // The calling thread's transform of this order. JUCE's fallback engine serialises calls on any
+    // one instance, so frames transformed in parallel each use their own thread's.
+    const juce::dsp::FFT& getTransform() const
+    {
+        thread_local std::array<std::unique_ptr<juce::dsp::FFT>, maxOrder + 1> transforms;
+        auto& transform = transforms[(size_t) order];
+
+        if (transform == nullptr)
+            transform = std::make_unique<juce::dsp::FFT> (order);
+
+        return *transform;
+    }
+
+    const int order, size;
+    std::vector<float> window;
+};
+
+int getFFTOrder (int fftSize)
+{
+    return juce::jlimit (8, 14, (int) std::round (std::log2 ((double) juce::jmax (1, fftSize))));
+}
+
+// The decimated mono taps of the micro burst the spectral and Morphogen unfolds read: at the output
+// rate, and squeezed into exactly one Morphogen seed frame.
+struct MicroTapFormat
+{
+    double rate;
+    int numSamples;
+};
+
+MicroTapFormat getSpectralTapFormat (int numMicroSamples, double microRate, double outRate)
+{
+    return { outRate, juce::jmax (32, (int) std::round ((double) numMicroSamples * outRate / microRate)) };
+}
+
+int getMorphogenSeedOrder (int fftSize)
+{
+    return fftSize > 0 ? getFFTOrder (fftSize) - 1 : 10;
+}
+
+MicroTapFormat getMorphogenTapFormat (int numMicroSamples, double microRate, int fftSize)
+{
+    const int seedFrameSize = 1 << getMorphogenSeedOrder (fftSize);
+    return { microRate * (double) (seedFrameSize - 1) / (double) juce::jmax (1, numMicroSamples), seedFrameSize };
+}
+
+// The spectral unfold's overlap-add is scaled for this size, whatever size it runs at: JUCE's
+// inverse transform already divides by its own size, so every size comes out at about one level.
+constexpr int referenceFFTSize = 2048;
+
+// Multi-resolution bands, lowest first: long windows resolve the lows, short ones keep the highs'
+// transients. Each band's upper edge is the next one's lower edge.
+struct SpectralBand
+{
+    int order;
+    double lowHz, highHz;
+};
+
+constexpr std::array<SpectralBand, 3> multiResolutionBands { { { 13, 0.0, 400.0 },
+                                                               { 11, 400.0, 3000.0 },
+                                                               { 9, 3000.0, 0.0 } } };
+
+// How much of a bin at hz belongs to the band [lowHz, highHz] (0 leaves that side open). Each edge
+// is a raised-cosine crossover an octave wide, and the bands either side of it get sin^2 and cos^2
+// of the same ramp, so adjacent bands always sum to one.
+float getBandWeight (double hz, double lowHz, double highHz)
+{
+    const auto above = [hz] (double edgeHz)
+    {
+        const auto t = juce::jlimit (0.0, 1.0, std::log2 (juce::jmax (1.0e-9, hz) / edgeHz) + 0.5);
+        return juce::square (std::sin (0.5 * juce::MathConstants<double>::pi * t));
+    };
+
+    const auto weight = (lowHz > 0.0 ? above (lowHz) : 1.0) * (highHz > 0.0 ? 1.0 - above (highHz) : 1.0);
+    return (float) weight;
+}
+
+// The spectral unfold's input side, which depends only on the burst's tap and the analysis framing:
+// the forward spectrum of each of the first numFrames analysis frames (channel frame, bins as
+// interleaved re/im pairs). Whatever the cache already holds is reused, so unfolds that differ in
+// anything else share it.
+RenderCache::Buffer getSpectralAnalysis (RenderCache* cache, juce::ThreadPool* workers, const RenderMonitor* monitor,
+                                         const juce::AudioBuffer<float>& tap, const FFTPlan& plan, int hopIn, int numFrames)
+{
+    const int tinySamples = tap.getNumSamples();
+    juce::uint64 key = 0;
+    RenderCache::Buffer cached;
+
+    if (cache != nullptr)
+    {
+        key = StageKey().add (tap.getReadPointer (0), tinySamples).add (plan.order).add (hopIn).get();
+        cached = cache->find (RenderCache::Stage::spectralAnalysis, key);
+
+        if (cached != nullptr && cached->getNumChannels() >= numFrames)
+            return cached;
+    }
+
+    const int framesCached = cached != nullptr ? cached->getNumChannels() : 0;
+    auto analysis = std::make_shared<juce::AudioBuffer<float>> (numFrames, plan.size + 2);
+
+    for (int frame = 0; frame < framesCached; ++frame)
+        analysis->copyFrom (frame, 0, *cached, frame, 0, plan.size + 2);
+
+    constexpr int framesPerTask = 16;
+    const auto* const input = tap.getReadPointer (0);
+    auto* const* channels = analysis->getArrayOfWritePointers();
+
+    TaskGraph graph;
+    for (int first = framesCached; first < numFrames; first += framesPerTask)
+    {
+        graph.add ([&, first]
+        {
+            const auto& fft = plan.getTransform();
+            std::vector<float> frameData ((size_t) (2 * plan.size));
+
+            for (int frame = first; frame < juce::jmin (first + framesPerTask, numFrames); ++frame)
+            {
+                const int inPos = (frame * hopIn) % tinySamples;
+
+                for (int n = 0; n < plan.size; ++n)
+                    frameData[(size_t) n] = input[(inPos + n) % tinySamples] * plan.window[(size_t) n];
+
+                fft.performRealOnlyForwardTransform (frameData.data(), true);
+                std::copy (frameData.begin(), frameData.begin() + plan.size + 2, channels[frame]);
+            }
+        });
+    }
+    graph.run (workers);
+
+    RenderProfile::count (profileOf (monitor), RenderProfile::Counter::bytesAllocated,
+                          (juce::int64) analysis->getNumChannels() * analysis->getNumSamples() * (juce::int64) sizeof (float));
+
+    if (cache != nullptr && ! isCancelled (monitor))
+        cache->store (RenderCache::Stage::spectralAnalysis, key, analysis);
+
+    return analysis;
+}
+
+void countOutput (RenderProfile* profile, const juce::AudioBuffer<float>& b)
+{
+    const auto samples = (juce::int64) b.getNumSamples() * b.getNumChannels();
+    RenderProfile::count (profile, RenderProfile::Counter::samplesWritten, samples);
+    RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated, samples * (juce::int64) sizeof (float));
+}
+
+// Renders numTiles stereo tiles a wave at a time on the workers, each into its own cleared scratch
+// buffer of scratchSamples, and passes each finished one to mergeTile in tile order. As long as a
+// tile's content depends only on its index, the merged result is the same whatever the wave size
+// or thread count, and only a wave's worth of scratch is ever held. Returns false if cancelled.
+template <typename RenderTile, typename MergeTile>
+bool runTileWaves (juce::ThreadPool* workers, int numTiles, int scratchSamples, const RenderMonitor* monitor,
+                   RenderTile&& renderTile, MergeTile&& mergeTile)
+{
+    const int tilesPerWave = workers != nullptr ? 2 * juce::jmax (1, workers->getNumThreads()) : 1;
+    std::vector<juce::AudioBuffer<float>> scratch ((size_t) juce::jlimit (1, juce::jmax (1, numTiles), tilesPerWave));
+
+    for (auto& s : scratch)
+        s.setSize (2, scratchSamples);
+
+    RenderProfile::count (profileOf (monitor), RenderProfile::Counter::bytesAllocated,
+                          (juce::int64) scratch.size() * scratchSamples * 2 * (juce::int64) sizeof (float));
+
+    for (int wave = 0; wave < numTiles; wave += (int) scratch.size())
+    {
+        const int waveTiles = juce::jmin ((int) scratch.size(), numTiles - wave);
+
+        TaskGraph graph;
+        for (int w = 0; w < waveTiles; ++w)
+        {
+            graph.add ([&, w]
+            {
+                auto& target = scratch[(size_t) w];
+                target.clear();
+                renderTile (wave + w, target);
+            });
+        }
+        graph.run (workers);
+
+        if (isCancelled (monitor))
+            return false;
+
+        for (int w = 0; w < waveTiles; ++w)
+            mergeTile (wave + w, std::as_const (scratch[(size_t) w]));
+    }
+
+    return true;
+}
+
+// Synthesizes events order[first, last) into target, whose first sample is burst sample
+// targetStart, and returns how many were done before any cancellation. Target must start out
+// cleared and reach at least maxMicroEventLength samples past the last event's start. Each event's sine runs from a double-precision phase
+// track (in turns) advanced by its instantaneous frequency, in one pass over the whole event.
+// Events are at most a few thousand turns long, so the track is only wrapped at the onset.
+int synthesizeMicroEvents (const MicroEventTable& events, const std::vector<int>& order, int first, int last,
+                           juce::AudioBuffer<float>& target, int targetStart, const RenderMonitor* monitor)
+{
+    const int numSamples = events.numSamples;
+    const int maxLen = maxMicroEventLength (events.microRate);
+    const double invRate = 1.0 / events.microRate;
+    const float nyquistLimit = (float) (0.49 * events.microRate);
+
+    std::vector<double> phase ((size_t) maxLen);
+    std::vector<float> osc ((size_t) maxLen), mod ((size_t) maxLen);
+
+    int k = first;
+    for (; k < last; ++k)
+    {
+        if (((k - first) & 255) == 0 && isCancelled (monitor))
+            break;
+
+        const auto e = (size_t) order[(size_t) k];
+        const int start = events.start[e];
+        const int len = juce::jmin (events.length[e], maxLen);
+        const int active = juce::jmin (len, numSamples - start);
+        const float f0 = events.f0[e];
+        const float slope = (events.f1[e] - f0) / (float) juce::jmax (1, len - 1);
+
+        // Glide from f0 to f1 (times ratio), starting in phase with the absolute sample position.
+        auto trackChirp = [&] (float ratio, const float* fm, float fmDepth)
+        {
+            auto ph = wrapTurns ((double) (f0 * ratio) * start * invRate);
+
+            for (int n = 0; n < active; ++n)
+            {
+                auto f = (f0 + slope * (float) n) * ratio;
+
+                if (fm != nullptr)
+                    f *= 1.0f + fmDepth * fm[n];
+                else
+                    f = juce::jlimit (30.0f, nyquistLimit, f);
+
+                phase[(size_t) n] = ph;
+                ph += f * invRate;
+            }
+        };
+
+        auto addSines = [&] (float gain, bool replace)
+        {
+            for (int n = 0; n < active; ++n)
+                osc[(size_t) n] = (replace ? 0.0f : osc[(size_t) n]) + gain * sinTurns (phase[(size_t) n]);
+        };
+
+        switch (events.type[e])
+        {
+            case MicroEventTable::fm:
+            {
+                const auto modStart = (double) events.fmRate[e] * start * invRate;
+                const auto modStep = (double) events.fmRate[e] * invRate;
+
+                for (int n = 0; n < active; ++n)
+                    mod[(size_t) n] = sinTurns (wrapTurns (modStart + modStep * n));
+
+                trackChirp (1.0f, mod.data(), events.fmDepth[e]);
+                addSines (1.0f, true);
+                break;
+            }
+
+            case MicroEventTable::additive:
+            {
+                const auto* detunes = events.detunes.data() + events.detuneOffset[e];
+
+                for (int p = 1; p <= (int) events.partials[e]; ++p)
+                {
+                    trackChirp ((float) p * detunes[p - 1], nullptr, 0.0f);
+                    addSines (0.8f / (float) p, p == 1);
+                }
+                break;
+            }
+
+            default:
+            {
+                trackChirp (1.0f, nullptr, 0.0f);
+                addSines (1.0f, true);
+
+                if (events.type[e] == MicroEventTable::noisyChirp)
+                {
+                    juce::Random noise (events.noiseSeed[e]);
+                    const auto blend = events.noiseBlend[e];
+
+                    for (int n = 0; n < active; ++n)
+                        osc[(size_t) n] = juce::jmap (blend, osc[(size_t) n], noise.nextFloat() * 2.0f - 1.0f);
+                }
+                break;
+            }
+        }
+
+        const float gainL = events.amp[e] * std::sqrt (1.0f - events.pan[e]);
+        const float gainR = events.amp[e] * std::sqrt (events.pan[e]);
+        const float invLen = 1.0f / (float) juce::jmax (1, len - 1);
+        auto* left = target.getWritePointer (0, start - targetStart);
+        auto* right = target.getWritePointer (1, start - targetStart);
+
+        for (int n = 0; n < active; ++n)
+        {
+            const float win = juce::square (sinTurns (0.5 * (double) ((float) n * invLen)));
+            const float shaped = win * std::tanh (1.8f * osc[(size_t) n]);
+            left[n] += shaped * gainL;
+            right[n] += shaped * gainR;
+        }
+    }
+
+    return k - first;
+}
+
+// Everything the spectral unfold's per-bin passes need about one frame, passed by value so that
+// nothing they read can alias the arrays they write.
+struct SpectralFrame
+{
+    float chaos, chaos2, frameU, dynWarp, srcExponent, tiltAmount, combDepth, combCycles, combOffset;
+    float formantBase, formantA, formantB, formantC, formantGainA, formantGainB, formantGainC;
+    float formantScaleA, formantScaleB, formantScaleC, stereoOffsetTurns;
+    float shimmer, shimmerPhaseScale, shimmerRotateRe, shimmerRotateIm, harmonicRatio;
+};
+
+// Where each bin of a frame reads the input spectrum from, and its tilt/comb/formant gain,
+// stereo phase offset and R phase rate. Split into loops with few enough streams that each
+// still vectorizes. The source positions always use the approximations, even in the exact-math
+// build: which source bin a bin reads, and takes its phase difference against, jumps as a position
+// crosses a whole bin, so the two builds could only be compared if they read the same bins.
+void buildSpectralCurves (const SpectralFrame f, int bins, const float* normK, const float* logNormK,
+                          float* srcPos, float* shaping, float* stereoOffset, float* rateR)
+{
+    for (int k = 0; k < bins; ++k)
+    {
+        const float srcA = (float) k / f.dynWarp;
+        const float srcB = FastMath::fastExp (f.srcExponent * logNormK[k]) * (float) (bins - 1);
+        srcPos[k] = juce::jlimit (0.0f, (float) (bins - 1), juce::jmap (0.5f + 0.5f * FastMath::sinTurns (0.17f * f.frameU + normK[k] * 0.9f), srcA, srcB));
+    }
+
+    for (int k = 0; k < bins; ++k)
+    {
+        const float u = normK[k];
+        const float tilt = fastExp ((u - 0.5f) * f.tiltAmount);
+        const float comb = (1.0f - f.combDepth) + f.combDepth * (0.5f + 0.5f * sinTurns (u * f.combCycles + f.combOffset + 0.25f));
+        const float formants = f.formantBase
+            + f.formantGainA * fastExp ((u - f.formantA) * (u - f.formantA) * f.formantScaleA)
+            + f.formantGainB * fastExp ((u - f.formantB) * (u - f.formantB) * f.formantScaleB)
+            + f.formantGainC * fastExp ((u - f.formantC) * (u - f.formantC) * f.formantScaleC);
+        shaping[k] = tilt * comb * formants;
+    }
+
+    for (int k = 0; k < bins; ++k)
+    {
+        const float u = normK[k];
+        stereoOffset[k] = ((0.015f + 0.05f * f.chaos) + (0.07f + 0.45f * f.chaos2) * u * u) * sinTurns (f.stereoOffsetTurns + u * 2.8f);
+        rateR[k] = 1.0f + (0.0001f + 0.0026f * f.chaos) * sinTurns (0.11f * f.frameU + u);
+    }
+}
+
+// A frame's direct and shimmer components per bin, in Cartesian form, from its shaped magnitudes
+// and accumulated phases. The accumulated phases are kept, and taken to turns, in double so that
+// they keep their precision however large they grow.
+void synthesizeSpectralBins (const SpectralFrame f, int bins, const float* normK, const float* mag,
+                             const double* sumL, const double* sumR, const float* stereoOffset,
+                             float* directLRe, float* directLIm, float* directRRe, float* directRIm,
+                             float* shimmerLRe, float* shimmerLIm, float* shimmerRRe, float* shimmerRIm)
+{
+    constexpr double turnsPerRadian = 1.0 / juce::MathConstants<double>::twoPi;
+
+    for (int k = 0; k < bins; ++k)
+    {
+        const double turnsL = sumL[k] * turnsPerRadian;
+        directLRe[k] = mag[k] * sinTurns (turnsL + 0.25);
+        directLIm[k] = mag[k] * sinTurns (turnsL);
+    }
+
+    for (int k = 0; k < bins; ++k)
+    {
+        const double turnsR = (sumR[k] + (double) stereoOffset[k]) * turnsPerRadian;
+        directRRe[k] = mag[k] * sinTurns (turnsR + 0.25);
+        directRIm[k] = mag[k] * sinTurns (turnsR);
+    }
+
+    for (int k = 0; k < bins; ++k)
+    {
+        const float shimmerMag = mag[k] * f.shimmer * (1.0f - (0.15f + 0.45f * f.chaos) * normK[k]);
+        const double shimmerTurns = sumL[k] * (double) f.shimmerPhaseScale * turnsPerRadian;
+        shimmerLRe[k] = shimmerMag * sinTurns (shimmerTurns + 0.25);
+        shimmerLIm[k] = shimmerMag * sinTurns (shimmerTurns);
+    }
+
+    for (int k = 0; k < bins; ++k)
+    {
+        const float re = shimmerLRe[k], im = shimmerLIm[k];
+        shimmerRRe[k] = re * f.shimmerRotateRe - im * f.shimmerRotateIm;
+        shimmerRIm[k] = re * f.shimmerRotateIm + im * f.shimmerRotateRe;
+    }
+}
+
+// Tables for resynthesizing sinusoids by inverse FFT at one size: the main lobe of a 4-term
+// Blackman-Harris window's spectrum, which is all of it down to -92 dB, and the time window that
+// turns what it gives back into a triangle over the frame's central half. Triangles a quarter frame
+// apart sum to one, so partials crossfade from frame to frame. Shared process-wide like FFTPlan.
+struct AdditiveKernel
+{
+    static constexpr int maxOrder = 13;
+    static constexpr int taps = 8;              // bins written per sinusoid, the lobe's full width
+    static constexpr int oversampling = 256;    // lobe table steps per bin
+
+    explicit AdditiveKernel (int orderIn)
+        : order (orderIn), size (1 << orderIn), lobe ((size_t) ((oversampling + 1) * taps)), postWindow ((size_t) (size / 2))
+    {
+        constexpr std::array<double, 4> coeffs { 0.35875, 0.48829, 0.14128, 0.01168 };
+        const auto pi = juce::MathConstants<double>::pi;
+        const auto n = (double) size;
+
+        // Sum of cos (2 pi y m / size) for |m| < size / 2: the window is taken to be zero at -size / 2,
+        // where it is 6e-5 anyway, so that its spectrum is real.
+        const auto dirichlet = [&] (double y)
+        {
+            return std::abs (y) < 1.0e-9 ? n - 1.0 : std::sin (pi * y * (n - 1.0) / n) / std::sin (pi * y / n);
+        };
+
+        for (int p = 0; p <= oversampling; ++p)
+        {
+            for (int t = 0; t < taps; ++t)
+            {
+                const auto x = (double) (t - taps / 2 + 1) - (double) p / oversampling;
+                auto w = 0.0;
+
+                for (int r = 0; r < (int) coeffs.size(); ++r)
+                    w += 0.5 * coeffs[(size_t) r] * (dirichlet (x - r) + dirichlet (x + r));
+
+                lobe[(size_t) (p * taps + t)] = (float) w;
+            }
+        }
+
+        for (int i = 0; i < size / 2; ++i)
+        {
+            const auto m = (double) (i - size / 4);
+            auto w = 0.0;
+
+            for (int r = 0; r < (int) coeffs.size(); ++r)
+                w += coeffs[(size_t) r] * std::cos (2.0 * pi * r * m / n);
+
+            postWindow[(size_t) i] = (float) ((1.0 - std::abs (m) / (0.25 * n)) / w);
+        }
+    }
+
+    static std::shared_ptr<const AdditiveKernel> get (int order)
+    {
+        jassert (order >= 0 && order <= maxOrder);
+
+        static juce::CriticalSection lock;
+        static std::array<std::shared_ptr<const AdditiveKernel>, maxOrder + 1> kernels;
+
+        const juce::ScopedLock sl (lock);
+        auto& kernel = kernels[(size_t) juce::jlimit (0, maxOrder, order)];
+
+        if (kernel == nullptr)
+            kernel = std::make_shared<const AdditiveKernel> (order);
+
+        return kernel;
+    }
+
+    const int order, size;
+    std::vector<float> lobe;         // (oversampling + 1) rows of taps, row p for a bin fraction of p / oversampling
+    std::vector<float> postWindow;   // frame samples -size / 4 to size / 4, in order
+};
+
+// Adds sinusoids' positive-frequency lobes to a frame's spectrum, each given by its frequency in
+// bins (any non-negative value: above Nyquist it aliases as a sampled oscillator would) and half its complex
+// amplitude at the frame's centre. Sample m of the frame is at index m mod size. The real frame's
+// spectrum is this plus its own conjugate, mirrored.
+void addAdditiveLobes (const AdditiveKernel& kernel, int numPartials, const float* bin, const float* re, const float* im,
+                       std::complex<float>* lobes)
+{
+    constexpr int taps = AdditiveKernel::taps;
+    const int mask = kernel.size - 1;
+
+    for (int i = 0; i < numPartials; ++i)
+    {
+        const float whole = std::floor (bin[i]);
+        const float pos = (bin[i] - whole) * (float) AdditiveKernel::oversampling;
+        const int p = juce::jmin ((int) pos, AdditiveKernel::oversampling - 1);
+        const float frac = pos - (float) p;
+        const float* row0 = kernel.lobe.data() + p * taps;
+        const float* row1 = row0 + taps;
+        const int first = (int) whole - taps / 2 + 1;
+
+        float w[taps];
+        for (int t = 0; t < taps; ++t)
+            w[t] = row0[t] + frac * (row1[t] - row0[t]);
+
+        for (int t = 0; t < taps; ++t)
+            lobes[(first + t) & mask] += std::complex<float> { re[i] * w[t], im[i] * w[t] };
+    }
+}
+
+// Diffusion along and across one row of Morphogen's reaction-diffusion plane, and the row's feed
+// and kill rates; passed by value, like SpectralFrame.
+struct ReactionRates
+{
+    float diffU, diffV, diffTime, feed, kill;
+};
+
+// One explicit Gray-Scott step of a row of the plane, from the row and the rows either side of it in
+// time. Neighbours along the row are read from ghost cells at index -1 and cells, so nothing wraps.
+// U and V are stepped in separate loops, few enough streams for each to vectorize.
+void stepReactionDiffusionRow (const ReactionRates r, int cells,
+                               const float* uAbove, const float* u, const float* uBelow,
+                               const float* vAbove, const float* v, const float* vBelow,
+                               float* nextU, float* nextV)
+{
+    for (int k = 0; k < cells; ++k)
+    {
+        const float lap = r.diffU * (u[k - 1] - 2.0f * u[k] + u[k + 1]) + r.diffTime * (uAbove[k] - 2.0f * u[k] + uBelow[k]);
+        const float du = lap - u[k] * v[k] * v[k] + r.feed * (1.0f - u[k]);
+        nextU[k] = juce::jlimit (0.0f, 1.5f, u[k] + du * 0.9f);
+    }
+
+    for (int k = 0; k < cells; ++k)
+    {
+        const float lap = r.diffV * (v[k - 1] - 2.0f * v[k] + v[k + 1]) + r.diffTime * (vAbove[k] - 2.0f * v[k] + vBelow[k]);
+        const float dv = lap + u[k] * v[k] * v[k] - (r.kill + r.feed) * v[k];
+        nextV[k] = juce::jlimit (0.0f, 1.5f, v[k] + dv * 0.9f);
+    }
+}
+}
+
+RenderEngine::RenderEngine (RenderCache* cacheIn, juce::ThreadPool* workersIn)
+    : cache (cacheIn), workers (workersIn)
+{
+}
+
+bool RenderEngine::setParameter (RenderRequest& request, const juce::String& paramID, float plainValue)
+{
+    // Each field is held to its plugin parameter's range, so batch files can't ask for renders the
+    // plugin couldn't make. Density goes up to Extended Event Density's range.
+    if (paramID == "mode")                request.mode = juce::jlimit (0, 7, (int) plainValue);
+    else if (paramID == "microRate")      request.microRate = getMicroRateForChoice (plainValue > 16.0f ? getMicroRateChoiceForRate (plainValue) : (int) plainValue);
+    else if (paramID == "burstMs")        request.burstMs = juce::jlimit (5.0f, 80.0f, plainValue);
+    else if (paramID == "density")        request.density = (int) juce::jlimit (1.0f, (float) maxDensity, plainValue);
+    else if (paramID == "outSeconds")     request.outSeconds = juce::jlimit (1.0f, 20.0f, plainValue);
+    else if (paramID == "grainMs")        request.grainMs = juce::jlimit (8.0f, 180.0f, plainValue);
+    else if (paramID == "overlap")        request.overlap = juce::jlimit (1.5f, 16.0f, plainValue);
+    else if (paramID == "stretch")        request.stretch = juce::jlimit (2.0f, 100.0f, plainValue);
+    else if (paramID == "warp")           request.warp = juce::jlimit (0.5f, 6.0f, plainValue);
+    else if (paramID == "spectralChaos")  request.spectralChaos = juce::jlimit (0.0f, 1.0f, plainValue);
+    else if (paramID == "hybridMix")      request.hybridMix = juce::jlimit (0.0f, 1.0f, plainValue);
+    else if (paramID == "seed")           request.seed = juce::jlimit (1, 999999, (int) plainValue);
+    else if (paramID == "spectralFloor")  request.spectralFloorDb = juce::jlimit (-140.0f, 0.0f, plainValue);
+    else if (paramID == "morphogenSynth") request.morphogenSynth = juce::jlimit (morphogenOscillators, morphogenIFFT, (int) plainValue);
+    else if (paramID == "morphogenBins")  request.morphogenBins = plainValue < 1.0f ? 0 : juce::jlimit (16, maxMorphogenBins, (int) plainValue);
+    else if (paramID == "morphogenField") request.morphogenField = juce::jlimit (morphogenRing, morphogenPlane, (int) plainValue);
+    else if (paramID == "morphogenCells") request.morphogenCells = plainValue < 1.0f ? 0 : juce::jlimit (16, maxMorphogenCells, (int) plainValue);
+    else if (paramID == "fftSize")        request.fftSize = plainValue > 16.0f ? juce::jlimit (256, 16384, juce::nextPowerOfTwo ((int) plainValue)) : getFFTSizeForChoice ((int) plainValue);
+    else                                  return false;
+
+    return true;
+}
+
+int RenderEngine::getMaxDensity (double microRate)
+{
+    return juce::jlimit (1, maxDensity, (int) (maxMicroBurstWork / maxMicroEventLength (microRate)));
+}
+
+double RenderEngine::getMicroRateForChoice (int choice)
+{
+    return choice <= 0 ? 192000.0 :
+           choice == 1 ? 384000.0 :
+           choice == 2 ? 768000.0 :
+           choice == 3 ? 1536000.0 :
+           choice == 4 ? 6144000.0 :
+           12288000.0;
+}
+
+int RenderEngine::getMicroRateChoiceForRate (double rate)
+{
+    for (int choice = 0; choice < numMicroRateChoices - 1; ++choice)
+        if (rate <= getMicroRateForChoice (choice))
+            return choice;
+
+    return numMicroRateChoices - 1;
+}
+
+int RenderEngine::getFFTSizeForChoice (int choice)
+{
+    return choice <= 0 ? 0 : 128 << juce::jmin (choice, numFFTSizeChoices - 1);
+}
+
+int RenderEngine::getNumPresets()
+{
+    return (int) getPresetBank().size();
+}
+
+const RenderPreset& RenderEngine::getPreset (int index)
+{
+    const auto& bank = getPresetBank();
+    return bank[(size_t) juce::jlimit (0, (int) bank.size() - 1, index)];
+}
+
+RenderRequest RenderEngine::makePresetRequest (int index, double outRate)
+{
+    const auto& p = getPreset (index);
+
+    RenderRequest r;
+    r.mode = p.mode;
+    r.microRate = getMicroRateForChoice (p.microRateChoice);
+    r.outRate = outRate;
+    r.burstMs = p.burstMs;
+    r.density = p.density;
+    r.outSeconds = p.outSeconds;
+    r.grainMs = p.grainMs;
+    r.overlap = p.overlap;
+    r.stretch = p.stretch;
+    r.warp = p.warp;
+    r.spectralChaos = p.spectralChaos;
+    r.hybridMix = p.hybridMix;
+    r.seed = p.seed;
+    return r;
+}
+
+juce::String RenderEngine::getStageName (RenderStage stage)
+{
+    switch (stage)
+    {
+        case RenderStage::idle:       return "Ready";
+        case RenderStage::queued:     return "Queued";
+        case RenderStage::microBurst: return "Micro burst";
+        case RenderStage::unfold:     return "Unfolding";
+        case RenderStage::bloom:      return "Bloom";
+        case RenderStage::normalize:  return "Normalize";
+        case RenderStage::finished:   return "Rendered";
+        default:                      return {};
+    }
+}
+
+RenderResult RenderEngine::render (const RenderRequest& request, RenderMonitor* monitor) const
+{
+    const RenderProfile::ScopedSpan span (profileOf (monitor), "render");
+
+    RenderResult result;
+    result.buffer = renderStages (request, monitor, result.microEvents);
+    result.sampleRate = request.outRate;
+    result.cancelled = isCancelled (monitor);
+    return result;
+}
+
+juce::AudioBuffer<float> RenderEngine::renderStages (const RenderRequest& request, RenderMonitor* monitor,
+                                                     std::shared_ptr<const MicroEventTable>& microEvents) const
+{
+    const auto mode = request.mode;
+    const auto burstMs = request.burstMs;
+    const auto outSeconds = request.outSeconds;
+    const auto density = juce::jmin (request.density, getMaxDensity (request.microRate));
+    const auto grainMs = request.grainMs;
+    const auto overlap = request.overlap;
+    const auto stretch = request.stretch;
+    const auto warp = request.warp;
+    const auto spectralChaos = request.spectralChaos;
+    const auto hybridMix = request.hybridMix;
+    const auto seed = request.seed;
+    const auto fftSize = request.fftSize;
+    const auto spectralFloorDb = request.spectralFloorDb;
+    const auto morphogenSynth = request.morphogenSynth;
+    const auto morphogenBins = request.morphogenBins;
+    const auto morphogenField = request.morphogenField;
+    const auto morphogenCells = request.morphogenCells;
+    const auto microRate = request.microRate;
+    const auto outRate = request.outRate;
+
+    auto report = [monitor] (RenderStage stage, float fraction)
+    {
+        if (monitor != nullptr)
+            monitor->reportProgress (stage, fraction);
+    };
+
+    // Each stage is looked up by a key over exactly the inputs it reads (including its upstream keys),
+    // and only computed on a miss. Partial results from a cancelled render are never stored.
+    using Stage = RenderCache::Stage;
+    auto runStage = [this, monitor] (Stage stage, juce::uint64 key, auto&& compute) -> RenderCache::Buffer
+    {
+        if (cache != nullptr)
+            if (auto hit = cache->find (stage, key))
+                return hit;
+
+        auto result = std::make_shared<const juce::AudioBuffer<float>> (compute());
+
+        if (cache != nullptr && ! isCancelled (monitor))
+            cache->store (stage, key, result);
+
+        return result;
+    };
+
+    if (cache != nullptr)
+        cache->beginRender();
+
+    const auto finishKey = StageKey().add (mode).add (microRate).add (outRate).add (burstMs).add (density)
+                                     .add (outSeconds).add (grainMs).add (overlap).add (stretch).add (warp)
+                                     .add (spectralChaos).add (hybridMix).add (seed).add (fftSize).add (spectralFloorDb)
+                                     .add (morphogenSynth).add (morphogenBins).add (morphogenField).add (morphogenCells).get();
+
+    const auto microKey = StageKey().add (microRate).add (burstMs).add (density).get();
+
+    if (cache != nullptr)
+    {
+        if (auto finished = cache->find (Stage::finish, finishKey))
+        {
+            microEvents = cache->findEvents (microKey);
+            return juce::AudioBuffer<float> (*finished);
+        }
+    }
+
+    // The event table is a stage of its own, so it comes back with a cached burst or render too.
+    report (RenderStage::microBurst, 0.0f);
+    if (cache != nullptr)
+        microEvents = cache->findEvents (microKey);
+
+    if (microEvents == nullptr)
+    {
+        microEvents = std::make_shared<const MicroEventTable> (makeMicroEvents (microRate, burstMs, density, monitor));
+
+        if (cache != nullptr && ! isCancelled (monitor))
+            cache->storeEvents (microKey, microEvents);
+    }
+
+    // The spectral and Morphogen unfolds only read a decimated mono tap of the burst. Unless another
+    // unfold needs the whole burst, the tap is synthesized tile by tile straight into the decimator
+    // (or taken from a whole burst still in the cache), so the burst is never held at the micro rate.
+    const bool needsWholeBurst = mode == 0 || mode == 3 || mode >= 5;
+    RenderCache::Buffer micro;
+
+    if (needsWholeBurst)
+    {
+        micro = runStage (Stage::microBurst, microKey, [&] { return synthesizeMicroBurst (*microEvents, monitor); });
+        if (isCancelled (monitor))
+            return {};
+    }
+
+    auto tapStage = [&] (MicroTapFormat format)
+    {
+        const auto key = StageKey().add (microKey).add (format.rate).add (format.numSamples).get();
+        return runStage (Stage::microTap, key, [&]
+        {
+            auto whole = micro;
+            if (whole == nullptr && cache != nullptr)
+                whole = cache->find (Stage::microBurst, microKey);
+
+            if (whole != nullptr)
+                return decimateMicroBurst (*whole, microRate, format.rate, format.numSamples);
+
+            return decimateMicroBurst (*microEvents, format.rate, format.numSamples, monitor);
+        });
+    };
+
+    report (RenderStage::unfold, 0.0f);
+
+    auto spectralStage = [&] (float st, float wp, float ch, int sd)
+    {
+        const auto key = StageKey().add (microKey).add (outRate).add (outSeconds).add (st).add (wp).add (ch).add (fftSize).add (spectralFloorDb).add (sd).get();
+        return std::make_pair (key, runStage (Stage::spectral, key, [&]
+        {
+            const auto tap = tapStage (getSpectralTapFormat (microEvents->numSamples, microRate, outRate));
+            return unfoldSpectralTap (*tap, outRate, outSeconds, st, wp, ch, fftSize, spectralFloorDb, sd, monitor);
+        }));
+    };
+
+    auto granularStage = [&] (const juce::AudioBuffer<float>& src, juce::uint64 srcKey, double srcRate, float grain, float ov, int sd)
+    {
+        const auto key = StageKey().add (srcKey).add (srcRate).add (outRate).add (outSeconds).add (grain).add (ov).add (sd).get();
+        return std::make_pair (key, runStage (Stage::granular, key, [&] { return unfoldGranular (src, srcRate, outRate, outSeconds, grain, ov, sd, monitor); }));
+    };
+
+    juce::AudioBuffer<float> out;
+    if (mode == 0)
+    {
+        out.makeCopyOf (*granularStage (*micro, microKey, microRate, grainMs, overlap, seed).second);
+    }
+    else if (mode == 1)
+    {
+        out.makeCopyOf (*spectralStage (stretch, warp, spectralChaos, seed).second);
+    }
+    else if (mode == 2)
+    {
+        const auto [spectralKey, spectral] = spectralStage (stretch, warp, spectralChaos, seed);
+        report (RenderStage::unfold, 0.6f);
+
+        const auto diffused = granularStage (*spectral,
+                                             spectralKey,
+                                             outRate,
+                                             juce::jlimit (10.0f, 220.0f, grainMs * 1.35f),
+                                             juce::jlimit (2.0f, 20.0f, overlap + 1.5f),
+                                             seed + 9176).second;
+
+        out.makeCopyOf (*spectral);
+        const float dryGain = juce::jmap (hybridMix, 1.0f, 0.55f);
+        const float wetGain = juce::jmap (hybridMix, 0.0f, 0.85f);
+        out.applyGain (dryGain);
+        out.addFrom (0, 0, *diffused, 0, 0, juce::jmin (out.getNumSamples(), diffused->getNumSamples()), wetGain);
+        out.addFrom (1, 0, *diffused, 1, 0, juce::jmin (out.getNumSamples(), diffused->getNumSamples()), wetGain);
+    }
+    else if (mode == 3)
+    {
+        // The spectral and granular branches only share the micro burst, so they run side by side.
+        const float chaos = juce::jlimit (0.0f, 1.0f, spectralChaos);
+        std::pair<juce::uint64, RenderCache::Buffer> spectral, granular;
+        RenderCache::Buffer xeno;
+
+        TaskGraph graph;
+        const auto spectralTask = graph.add ([&]
+        {
+            spectral = spectralStage (juce::jlimit (8.0f, 120.0f, stretch * (1.1f + 0.7f * chaos)),
+                                      juce::jlimit (0.7f, 6.5f, warp * (0.9f + 0.6f * chaos)),
+                                      juce::jlimit (0.35f, 1.0f, spectralChaos + 0.22f),
+                                      seed + 404);
+            report (RenderStage::unfold, 0.3f);
+        });
+
+        const auto granularTask = graph.add ([&]
+        {
+            granular = granularStage (*micro,
+                                      microKey,
+                                      microRate,
+                                      juce::jlimit (10.0f, 200.0f, grainMs * (0.9f + 1.1f * chaos)),
+                                      juce::jlimit (1.5f, 20.0f, overlap * (0.8f + 1.0f * chaos)),
+                                      seed + 9091);
+            report (RenderStage::unfold, 0.3f);
+        });
+
+        graph.add ([&]
+        {
+            if (isCancelled (monitor))
+                return;
+
+            report (RenderStage::unfold, 0.5f);
+            const auto xenoKey = StageKey().add (spectral.first).add (granular.first).add (outRate).add (stretch).add (warp)
+                                           .add (spectralChaos).add (hybridMix).add (seed).get();
+            xeno = runStage (Stage::xeno, xenoKey, [&]
+            {
+                return unfoldXeno (*spectral.second, *granular.second, outRate, stretch, warp, spectralChaos, hybridMix, seed, monitor);
+            });
+        }, { spectralTask, granularTask });
+
+        graph.run (workers);
+
+        if (xeno == nullptr || isCancelled (monitor))
+            return {};
+
+        out.makeCopyOf (*xeno);
+    }
+    else if (mode == 4)
+    {
+        const auto morphogenKey = StageKey().add (microKey).add (outRate).add (outSeconds).add (stretch).add (warp)
+                                            .add (spectralChaos).add (hybridMix).add (fftSize).add (morphogenSynth)
+                                            .add (morphogenBins).add (morphogenField).add (morphogenCells).add (seed).get();
+        out.makeCopyOf (*runStage (Stage::morphogen, morphogenKey, [&]
+        {
+            const auto tap = tapStage (getMorphogenTapFormat (microEvents->numSamples, microRate, fftSize));
+            return unfoldMorphogenTap (*tap, outRate, outSeconds, stretch, warp, spectralChaos, hybridMix, fftSize,
+                                       morphogenSynth, morphogenBins, morphogenField, morphogenCells, seed, monitor);
+        }));
+    }
+    else if (mode == 5)
+    {
+        // As in Xeno, the two branches run side by side and go through the stage cache, so the
+        // spectral one reads the shared micro tap.
+        std::pair<juce::uint64, RenderCache::Buffer> spectral, granular;
+        RenderCache::Buffer fennesz;
+
+        TaskGraph graph;
+        const auto spectralTask = graph.add ([&]
+        {
+            spectral = spectralStage (juce::jlimit (8.0f, 120.0f, stretch * 1.25f),
+                                      juce::jlimit (0.8f, 6.2f, warp * 0.9f),
+                                      juce::jlimit (0.1f, 0.95f, spectralChaos * 0.75f + 0.15f),
+                                      seed + 1001);
+            report (RenderStage::unfold, 0.3f);
+        });
+
+        const auto granularTask = graph.add ([&]
+        {
+            granular = granularStage (*micro,
+                                      microKey,
+                                      microRate,
+                                      juce::jlimit (18.0f, 220.0f, 52.0f + 90.0f * hybridMix),
+                                      juce::jlimit (2.0f, 18.0f, 5.0f + 8.0f * hybridMix),
+                                      seed + 2002);
+            report (RenderStage::unfold, 0.3f);
+        });
+
+        graph.add ([&]
+        {
+            if (isCancelled (monitor))
+                return;
+
+            report (RenderStage::unfold, 0.5f);
+            const auto fenneszKey = StageKey().add (spectral.first).add (granular.first).add (outRate).add (spectralChaos)
+                                              .add (hybridMix).add (seed).get();
+            fennesz = runStage (Stage::fennesz, fenneszKey, [&]
+            {
+                return unfoldFennesz (*spectral.second, *granular.second, outRate, spectralChaos, hybridMix, seed, monitor);
+            });
+        }, { spectralTask, granularTask });
+
+        graph.run (workers);
+
+        if (fennesz == nullptr || isCancelled (monitor))
+            return {};
+
+        out.makeCopyOf (*fennesz);
+    }
+    else if (mode == 6)
+    {
+        const auto notoKey = StageKey().add (microKey).add (outRate).add (outSeconds).add (stretch).add (warp)
+                                       .add (spectralChaos).add (seed).get();
+        out.makeCopyOf (*runStage (Stage::noto, notoKey, [&]
+        {
+            return unfoldNoto (*micro, microRate, outRate, outSeconds, stretch, warp, spectralChaos, seed, monitor);
+        }));
+    }
+    else
+    {
+        const auto ikedaKey = StageKey().add (microKey).add (outRate).add (outSeconds).add (stretch).add (warp)
+                                        .add (spectralChaos).add (seed).get();
+        out.makeCopyOf (*runStage (Stage::ikeda, ikedaKey, [&]
+        {
+            return unfoldIkeda (*micro, microRate, outRate, outSeconds, stretch, warp, spectralChaos, seed, monitor);
+        }));
+    }
+
+    if (isCancelled (monitor))
+        return {};
+
+    report (RenderStage::bloom, 0.0f);
+    auto* profile = profileOf (monitor);
+    {
+        const RenderProfile::ScopedSpan span (profile, "sanitize");
+        sanitizeBufferInPlace (out);
+    }
+    {
+        const RenderProfile::ScopedSpan span (profile, "bloom");
+        const float bloomAmount = juce::jlimit (0.15f, 1.0f, 0.35f + 0.35f * spectralChaos + (mode >= 2 ? 0.18f : 0.0f));
+        applyBloomInPlace (out, outRate, seed + 11731, bloomAmount);
+    }
+    report (RenderStage::normalize, 0.0f);
+    {
+        const RenderProfile::ScopedSpan span (profile, "normalize");
+        sanitizeBufferInPlace (out);
+        normalizeInPlace (out);
+    }
+    report (RenderStage::normalize, 1.0f);
+
+    if (cache != nullptr && ! isCancelled (monitor))
+        cache->store (Stage::finish, finishKey, std::make_shared<const juce::AudioBuffer<float>> (out));
+
+    return out;
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldXeno (const juce::AudioBuffer<float>& spectral,
+                                                   const juce::AudioBuffer<float>& granular,
+                                                   double outRate,
+                                                   float stretch,
+                                                   float spectralWarp,
+                                                   float spectralChaos,
+                                                   float hybridMix,
+                                                   int seed,
+                                                   const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "xeno");
+
+    const float chaos = juce::jlimit (0.0f, 1.0f, spectralChaos);
+    const int xenoFlavor = ((seed * 3) + (int) std::round (spectralWarp * 17.0f) + (int) std::round (stretch * 3.0f) + (int) std::round (hybridMix * 100.0f)) & 3;
+
+    juce::AudioBuffer<float> out;
+    out.setSize (2, juce::jmax (spectral.getNumSamples(), granular.getNumSamples()));
+    out.clear();
+
+    const int outSamples = out.getNumSamples();
+    juce::Random rng (seed + 31337);
+    float hx = 0.11f + 0.03f * rng.nextFloat();
+    float hy = -0.17f + 0.03f * rng.nextFloat();
+    const uint32_t seedU = (uint32_t) seed;
+    uint32_t ca = seedU * 747796405u + 2891336453u;
+    const int maskBits = 6 + (int) std::round (18.0f * chaos);
+    const uint32_t mask = maskBits >= 31 ? 0x7fffffffu : ((1u << maskBits) - 1u);
+    const float spectralBlend = juce::jlimit (0.15f, 0.8f, 0.18f + 0.62f * (1.0f - hybridMix) + 0.07f * (float) xenoFlavor);
+    const float granularBlend = juce::jlimit (0.10f, 0.8f, 0.15f + 0.55f * hybridMix + 0.06f * (float) (3 - xenoFlavor));
+    const float xenoBlend = juce::jlimit (0.35f, 1.1f, 0.45f + 0.45f * chaos + 0.08f * (float) xenoFlavor);
+
+    for (int i = 0; i < outSamples; ++i)
+    {
+        const float u = (float) i / (float) juce::jmax (1, outSamples - 1);
+
+        if ((i & 7) == 0)
+        {
+            const uint32_t left = (ca << (1 + (xenoFlavor & 1))) | (ca >> (31 - (xenoFlavor & 1)));
+            const uint32_t right = (ca >> (1 + ((xenoFlavor >> 1) & 1))) | (ca << (31 - ((xenoFlavor >> 1) & 1)));
+            if (xenoFlavor == 0)
+                ca = left ^ (ca | right);
+            else if (xenoFlavor == 1)
+                ca = (left & ~right) ^ (ca >> 3);
+            else if (xenoFlavor == 2)
+                ca = (left + right) ^ (ca << 5);
+            else
+                ca = (left ^ right) + (ca * 1664525u + 1013904223u);
+        }
+
+        const float gate = (float) popcount32 (ca & mask) / (float) juce::jmax (1, maskBits);
+        const float a = (xenoFlavor == 2 ? 1.34f : 1.22f) + (0.42f + 0.26f * chaos) * std::sin (twoPi * ((0.21f + 0.11f * xenoFlavor) * u) + (2.3f + 1.7f * xenoFlavor) * gate);
+        const float b = (xenoFlavor == 3 ? 0.22f : 0.15f) + (0.16f + 0.09f * chaos) * std::sin (twoPi * ((0.43f + 0.08f * xenoFlavor) * u) + (5.1f - 0.9f * xenoFlavor) * gate);
+        const float px = hx;
+        hx = 1.0f - a * hx * hx + hy;
+        hy = b * px;
+        if (! std::isfinite (hx) || ! std::isfinite (hy))
+        {
+            hx = 0.09f;
+            hy = -0.13f;
+        }
+        hx = juce::jlimit (-2.0f, 2.0f, hx);
+        hy = juce::jlimit (-2.0f, 2.0f, hy);
+
+        const float noise = (rng.nextFloat() * 2.0f - 1.0f) * (0.08f + 0.28f * chaos);
+        float xenoL = 0.0f;
+        float xenoR = 0.0f;
+        if (xenoFlavor == 0)
+        {
+            xenoL = std::tanh ((hx * (1.1f + 1.8f * chaos) + noise) * (0.6f + 1.1f * gate));
+            xenoR = std::tanh ((hy * (1.3f + 1.6f * chaos) - noise) * (0.6f + 1.1f * (1.0f - gate)));
+        }
+        else if (xenoFlavor == 1)
+        {
+            xenoL = std::sin (twoPi * (0.15f * i + std::abs (hx) * (1.4f + 4.2f * chaos))) * std::tanh (hy * (1.2f + 1.3f * chaos) + noise);
+            xenoR = std::sin (twoPi * (0.12f * i + std::abs (hy) * (1.7f + 3.8f * chaos))) * std::tanh (hx * (1.0f + 1.5f * chaos) - noise);
+        }
+        else if (xenoFlavor == 2)
+        {
+            const float q = std::tanh ((hx - hy) * (2.2f + 1.7f * chaos));
+            xenoL = std::tanh ((hx + 0.6f * q + noise) * (1.0f + 1.9f * gate));
+            xenoR = std::tanh ((hy - 0.6f * q - noise) * (1.0f + 1.9f * (1.0f - gate)));
+        }
+        else
+        {
+            const float c = std::cos (twoPi * (0.004f * i + gate * 3.0f));
+            xenoL = std::tanh ((hx * c + hy * (1.0f - c) + noise) * (1.4f + 1.1f * chaos));
+            xenoR = std::tanh ((hy * c - hx * (1.0f - c) - noise) * (1.4f + 1.1f * chaos));
+        }
+
+        const float sL = i < spectral.getNumSamples() ? spectral.getSample (0, i) : 0.0f;
+        const float sR = i < spectral.getNumSamples() ? spectral.getSample (1, i) : 0.0f;
+        const float gL = i < granular.getNumSamples() ? granular.getSample (0, i) : 0.0f;
+        const float gR = i < granular.getNumSamples() ? granular.getSample (1, i) : 0.0f;
+
+        out.setSample (0, i, spectralBlend * sL + granularBlend * gL + xenoBlend * xenoL);
+        out.setSample (1, i, spectralBlend * sR + granularBlend * gR + xenoBlend * xenoR);
+    }
+
+    juce::AudioBuffer<float> folded;
+    folded.makeCopyOf (out);
+    const int segLen = juce::jmax (64, (int) std::round (outRate * ((0.010f + 0.020f * xenoFlavor) + (0.045f + 0.040f * xenoFlavor) * chaos)));
+    const int hop = juce::jmax (16, segLen / (2 + (xenoFlavor % 3)));
+    const int stride = 5 + ((seed + 3 * xenoFlavor) % 29);
+    int cursor = (seed * 37) % juce::jmax (1, outSamples);
+
+    for (int dst = 0; dst < outSamples; dst += hop)
+    {
+        cursor = (cursor + stride * segLen) % juce::jmax (1, outSamples);
+        for (int n = 0; n < segLen; ++n)
+        {
+            const int di = dst + n;
+            if (di >= outSamples)
+                break;
+
+            const int si = (cursor + n) % juce::jmax (1, outSamples);
+            const float w = 0.5f - 0.5f * std::cos (twoPi * (float) n / (float) juce::jmax (1, segLen - 1));
+            out.addSample (0, di, folded.getSample (0, si) * w * (0.10f + 0.36f * chaos));
+            out.addSample (1, di, folded.getSample (1, si) * w * (0.10f + 0.36f * chaos));
+        }
+    }
+
+    // Symbolic phase-grammar transduction:
+    // convert evolving bit/attractor states into a five-symbol rewrite process
+    // that decides time reads, polarity, and non-linear fold strength.
+    juce::AudioBuffer<float> grammarSrc;
+    grammarSrc.makeCopyOf (out);
+    const std::array<int, 8> primeHops { 2, 3, 5, 7, 11, 13, 17, 19 };
+    uint32_t grammarState = seedU ^ 0x9e3779b9u;
+    const int symbolCount = 5 + xenoFlavor;
+
+    for (int i = 0; i < outSamples; ++i)
+    {
+        grammarState ^= grammarState << 13;
+        grammarState ^= grammarState >> 17;
+        grammarState ^= grammarState << 5;
+
+        const uint32_t iU = (uint32_t) i;
+        const int symbol = (int) ((grammarState ^ (iU * 2654435761u)) % (uint32_t) symbolCount);
+        const int hopPrime = primeHops[(size_t) (grammarState & 7u)];
+        const int back = (hopPrime * (17 + (7 + xenoFlavor) * symbol) + (i % (29 + (19 + 3 * xenoFlavor) * symbol))) % juce::jmax (1, outSamples);
+        const int read = (i - back + outSamples) % juce::jmax (1, outSamples);
+
+        const float srcL = grammarSrc.getSample (0, read);
+        const float srcR = grammarSrc.getSample (1, read);
+        const float srcMid = 0.5f * (srcL + srcR);
+        const float polarity = ((symbol + xenoFlavor) & 1) ? -1.0f : 1.0f;
+        const float fold = 0.9f + (2.6f + 0.7f * xenoFlavor) * chaos + 0.42f * (float) symbol;
+        const float symBlend = (0.04f + (0.18f + 0.05f * xenoFlavor) * chaos)
+            * (0.55f + 0.45f * (float) symbol / (float) juce::jmax (1, symbolCount - 1));
+
+        const float injectL = std::tanh (fold * (srcL + 0.35f * srcMid)) * polarity;
+        const float injectR = std::tanh (fold * (srcR - 0.35f * srcMid)) * (-polarity);
+
+        out.addSample (0, i, injectL * symBlend);
+        out.addSample (1, i, injectR * symBlend);
+    }
+
+    if (isCancelled (monitor))
+        return out;
+
+    // Autocatalytic shadow resynthesis:
+    // a self-referential moving-read process where local energy steers feedback gain.
+    juce::AudioBuffer<float> shadow;
+    shadow.makeCopyOf (out);
+    const int baseD1 = juce::jmax (7, (int) std::round (outRate * ((0.001 + 0.0015 * xenoFlavor) + (0.007 + 0.002f * xenoFlavor) * chaos)));
+    const int baseD2 = juce::jmax (11, (int) std::round (outRate * ((0.004 + 0.0020 * xenoFlavor) + (0.010 + 0.003f * xenoFlavor) * chaos)));
+    const int baseD3 = juce::jmax (17, (int) std::round (outRate * ((0.008 + 0.0030 * xenoFlavor) + (0.014 + 0.004f * xenoFlavor) * chaos)));
+
+    for (int i = 0; i < outSamples; ++i)
+    {
+        const float t = (float) i / (float) juce::jmax (1, outSamples - 1);
+        const int d1 = baseD1 + (int) std::round ((0.5f + 0.5f * std::sin (twoPi * (7.1f * t))) * baseD2);
+        const int d2 = baseD2 + (int) std::round ((0.5f + 0.5f * std::sin (twoPi * (13.7f * t + 0.3f))) * baseD3);
+        const int d3 = baseD3 + (int) std::round ((0.5f + 0.5f * std::sin (twoPi * (3.9f * t + 1.1f))) * baseD1);
+
+        const int r1 = (i - d1 + outSamples) % juce::jmax (1, outSamples);
+        const int r2 = (i - d2 + outSamples) % juce::jmax (1, outSamples);
+        const int r3 = (i - d3 + outSamples) % juce::jmax (1, outSamples);
+
+        const float s1L = shadow.getSample (0, r1), s1R = shadow.getSample (1, r1);
+        const float s2L = shadow.getSample (0, r2), s2R = shadow.getSample (1, r2);
+        const float s3L = shadow.getSample (0, r3), s3R = shadow.getSample (1, r3);
+
+        const float e = 0.5f * (std::abs (out.getSample (0, i)) + std::abs (out.getSample (1, i)));
+        const float catalyst = juce::jlimit (0.0f, 1.0f, (0.15f + 0.85f * chaos) * (0.3f + 2.3f * e));
+        const float mixA = 0.53f - 0.23f * catalyst;
+        const float mixB = 0.31f + 0.17f * catalyst;
+        const float mixC = 0.16f + 0.21f * catalyst;
+
+        const float resynL = std::tanh ((mixA * s1L + mixB * s2R - mixC * s3L) * (1.0f + 2.0f * catalyst));
+        const float resynR = std::tanh ((mixA * s1R + mixB * s2L - mixC * s3R) * (1.0f + 2.0f * catalyst));
+
+        out.addSample (0, i, resynL * (0.05f + 0.27f * chaos));
+        out.addSample (1, i, resynR * (0.05f + 0.27f * chaos));
+    }
+
+    countOutput (profile, out);
+    return out;
+}
+
+bool RenderEngine::writeWav (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    if (file.existsAsFile())
+        file.deleteFile();
+
+    if (auto fileStream = file.createOutputStream())
+    {
+        std::unique_ptr<juce::OutputStream> stream (std::move (fileStream));
+        juce::WavAudioFormat wav;
+        auto options = juce::AudioFormatWriterOptions {}
+            .withSampleRate (sampleRate)
+            .withNumChannels (buffer.getNumChannels())
+            .withBitsPerSample (24)
+            .withSampleFormat (juce::AudioFormatWriterOptions::SampleFormat::integral);
+
+        if (auto writer = wav.createWriterFor (stream, options))
+        {
+            return writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+        }
+    }
+
+    return false;
+}
+
+MicroEventTable RenderEngine::makeMicroEvents (double microRate, double burstMs, int density, const RenderMonitor* monitor)
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "micro events");
+
+    MicroEventTable events;
+    events.microRate = microRate;
+    events.numSamples = juce::jmax (16, (int) std::round (microRate * burstMs * 0.001));
+
+    density = juce::jlimit (0, getMaxDensity (microRate), density);
+    const auto numEvents = (size_t) density;
+    for (auto* v : { &events.start, &events.length, &events.detuneOffset })
+        v->resize (numEvents);
+    for (auto* v : { &events.amp, &events.pan, &events.f0, &events.f1, &events.fmRate, &events.fmDepth, &events.noiseBlend })
+        v->resize (numEvents);
+    events.type.resize (numEvents);
+    events.partials.resize (numEvents);
+    events.noiseSeed.resize (numEvents);
+
+    // Each event draws from its own random stream, so its parameters don't depend on the others.
+    const auto streamSeed = (juce::int64) density * 1103515245 + events.numSamples;
+    const int maxLen = maxMicroEventLength (microRate);
+    const float nyquistLimit = (float) (0.49 * microRate);
+
+    for (size_t i = 0; i < numEvents; ++i)
+    {
+        // A million events take about 0.1 s to draw, so a superseded render stops here too.
+        if ((i & 4095) == 0 && isCancelled (monitor))
+        {
+            MicroEventTable cancelled;
+            cancelled.microRate = microRate;
+            cancelled.numSamples = events.numSamples;
+            return cancelled;
+        }
+
+        juce::Random rng (eventSeed (streamSeed, (int) i));
+
+        events.start[i] = rng.nextInt (events.numSamples);
+        events.length[i] = juce::jlimit (6, maxLen, 6 + rng.nextInt ((int) (0.0038 * microRate) + 1));
+        events.amp[i] = std::pow (rng.nextFloat(), 2.1f) * 0.14f;
+        events.pan[i] = rng.nextFloat();
+        events.type[i] = (juce::uint8) rng.nextInt (4);
+        events.f0[i] = 40.0f + std::pow (rng.nextFloat(), 2.0f) * (float) (0.47 * microRate);
+        events.f1[i] = juce::jlimit (20.0f, nyquistLimit, events.f0[i] * (0.35f + 3.7f * rng.nextFloat()));
+        events.fmRate[i] = 8.0f + 4200.0f * std::pow (rng.nextFloat(), 2.5f);
+        events.fmDepth[i] = 0.04f + 0.75f * rng.nextFloat();
+        events.noiseBlend[i] = std::pow (rng.nextFloat(), 1.4f);
+        events.partials[i] = (juce::uint8) (2 + rng.nextInt (5));
+        events.detuneOffset[i] = (int) events.detunes.size();
+
+        if (events.type[i] == MicroEventTable::additive)
+            for (int p = 0; p < (int) events.partials[i]; ++p)
+                events.detunes.push_back (1.0f + (rng.nextFloat() * 2.0f - 1.0f) * 0.04f);
+
+        events.noiseSeed[i] = rng.nextInt64();
+    }
+
+    RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated,
+                          (juce::int64) numEvents * (juce::int64) (7 * sizeof (float) + 3 * sizeof (int) + 2 + sizeof (juce::int64))
+                              + (juce::int64) (events.detunes.size() * sizeof (float)));
+    return events;
+}
+
+bool RenderEngine::synthesizeMicroBurst (const MicroEventTable& events, const MicroTileConsumer& consumer, const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "micro burst");
+
+    const int numSamples = events.numSamples;
+    const int numEvents = events.size();
+    const int numTiles = (numSamples + microTileSamples - 1) / microTileSamples;
+    const int scratchSamples = microTileSamples + maxMicroEventLength (events.microRate);
+
+    // Events are bucketed by the tile they start in; within a tile they are grouped by type and
+    // taken in start order, so consecutive events run the same code and write nearby samples.
+    std::vector<int> order ((size_t) numEvents);
+    std::iota (order.begin(), order.end(), 0);
+    std::sort (order.begin(), order.end(), [&events] (int x, int y)
+    {
+        const auto sx = events.start[(size_t) x], sy = events.start[(size_t) y];
+        return std::make_tuple (sx / microTileSamples, events.type[(size_t) x], sx, x)
+             < std::make_tuple (sy / microTileSamples, events.type[(size_t) y], sy, y);
+    });
+
+    std::vector<int> tileBegin ((size_t) numTiles + 1, numEvents);
+    for (int k = numEvents; --k >= 0;)
+        tileBegin[(size_t) (events.start[(size_t) order[(size_t) k]] / microTileSamples)] = k;
+    for (int t = numTiles; --t >= 0;)
+        tileBegin[(size_t) t] = juce::jmin (tileBegin[(size_t) t], tileBegin[(size_t) t + 1]);
+
+    // Tiles are synthesized in parallel and added into a running accumulator in tile order. Once a
+    // tile is added, no later event can reach its samples, so they are handed on; memory stays at a
+    // few tiles whatever the burst length, micro rate or density.
+    juce::AudioBuffer<float> pending (2, scratchSamples);
+    pending.clear();
+
+    RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated,
+                          (juce::int64) scratchSamples * 2 * (juce::int64) sizeof (float)
+                              + (juce::int64) (order.size() + tileBegin.size()) * (juce::int64) sizeof (int));
+
+    return runTileWaves (workers, numTiles, scratchSamples, monitor,
+                         [&] (int tile, juce::AudioBuffer<float>& target)
+                         {
+                             const auto done = synthesizeMicroEvents (events, order, tileBegin[(size_t) tile], tileBegin[(size_t) tile + 1],
+                                                                      target, tile * microTileSamples, monitor);
+                             RenderProfile::count (profile, RenderProfile::Counter::eventsSynthesized, done);
+                         },
+                         [&] (int tile, const juce::AudioBuffer<float>& scratch)
+                         {
+                             const int tileStart = tile * microTileSamples;
+
+                             for (int ch = 0; ch < 2; ++ch)
+                                 pending.addFrom (ch, 0, scratch, ch, 0, scratchSamples);
+
+                             consumer (pending, tileStart, juce::jmin (microTileSamples, numSamples - tileStart));
+
+                             for (int ch = 0; ch < 2; ++ch)
+                             {
+                                 auto* d = pending.getWritePointer (ch);
+                                 std::memmove (d, d + microTileSamples, (size_t) (scratchSamples - microTileSamples) * sizeof (float));
+                                 juce::FloatVectorOperations::clear (d + scratchSamples - microTileSamples, microTileSamples);
+                             }
+                         });
+}
+
+juce::AudioBuffer<float> RenderEngine::synthesizeMicroBurst (const MicroEventTable& events, const RenderMonitor* monitor) const
+{
+    juce::AudioBuffer<float> b (2, events.numSamples);
+    b.clear();
+
+    synthesizeMicroBurst (events, [&b] (const juce::AudioBuffer<float>& tile, int startSample, int numSamples)
+    {
+        for (int ch = 0; ch < 2; ++ch)
+            b.copyFrom (ch, startSample, tile, ch, 0, numSamples);
+    }, monitor);
+
+    countOutput (profileOf (monitor), b);
+    return b;
+}
+
+juce::AudioBuffer<float> RenderEngine::renderMicroBurst (double microRate,
+                                                         double burstMs,
+                                                         int density,
+                                                         const RenderMonitor* monitor) const
+{
+    return synthesizeMicroBurst (makeMicroEvents (microRate, burstMs, density, monitor), monitor);
+}
+
+juce::AudioBuffer<float> RenderEngine::decimateMicroBurst (const juce::AudioBuffer<float>& micro, double microRate, double rate, int numSamples)
+{
+    const auto mono = toMono (micro);
+    juce::AudioBuffer<float> tap (1, numSamples);
+    Decimator::get (microRate, rate)->process (mono.getReadPointer (0), mono.getNumSamples(), tap.getWritePointer (0), numSamples);
+    return tap;
+}
+
+juce::AudioBuffer<float> RenderEngine::decimateMicroBurst (const MicroEventTable& events, double rate, int numSamples,
+                                                           const RenderMonitor* monitor) const
+{
+    juce::AudioBuffer<float> tap (1, numSamples);
+    tap.clear();
+
+    // Each finished tile is mixed down the way toMono does it and pushed on, then dropped.
+    const auto decimator = Decimator::get (events.microRate, rate);
+    Decimator::Stream stream (*decimator, events.numSamples, tap.getWritePointer (0), numSamples);
+    std::vector<float> mono ((size_t) microTileSamples);
+
+    synthesizeMicroBurst (events, [&] (const juce::AudioBuffer<float>& tile, int, int tileSamples)
+    {
+        juce::FloatVectorOperations::copyWithMultiply (mono.data(), tile.getReadPointer (0), 0.5f, tileSamples);
+        juce::FloatVectorOperations::addWithMultiply (mono.data(), tile.getReadPointer (1), 0.5f, tileSamples);
+        stream.push (mono.data(), tileSamples);
+    }, monitor);
+
+    countOutput (profileOf (monitor), tap);
+    return tap;
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldGranular (const juce::AudioBuffer<float>& micro,
+                                                       double microRate,
+                                                       double outRate,
+                                                       double outSeconds,
+                                                       float grainOutMs,
+                                                       float overlap,
+                                                       int seed,
+                                                       const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "granular");
+
+    const int outSamples = juce::jmax (1, (int) std::round (outRate * outSeconds));
+    juce::AudioBuffer<float> out (2, outSamples);
+    out.clear();
+
+    juce::Random rng (seed);
+
+    const int microSamples = micro.getNumSamples();
+    const int grainOutSamples = juce::jmax (8, (int) std::round (grainOutMs * 0.001 * outRate));
+    const int hopOut = juce::jmax (1, (int) std::round ((double) grainOutSamples / juce::jmax (1.0f, overlap)));
+
+    const int grainInSamples = juce::jlimit (8,
+                                             juce::jmax (9, microSamples - 2),
+                                             (int) std::round ((double) grainOutSamples * microRate / outRate * 0.2));
+
+    // The whole schedule is drawn first, in the original order, so the grains do not depend on how
+    // the rendering below is split up.
+    std::vector<Grain> grains;
+    grains.reserve ((size_t) (outSamples / hopOut + 1));
+
+    for (int outPos = 0; outPos < outSamples; outPos += hopOut)
+    {
+        if (isCancelled (monitor))
+            break;
+
+        const int srcStart = rng.nextInt (juce::jmax (1, microSamples - grainInSamples));
+        const float jitter = rng.nextFloat() * 2.0f - 1.0f;
+        const float gain = 0.05f + 0.23f * std::pow (rng.nextFloat(), 1.6f);
+        const float speed = juce::jlimit (0.3f, 2.6f, 0.45f + 2.1f * rng.nextFloat() * rng.nextFloat());
+        const bool reverse = rng.nextFloat() < 0.17f;
+        const float grainPan = rng.nextFloat();
+        const float grainBrightness = 0.2f + 0.8f * rng.nextFloat();
+
+        Grain g;
+        g.outPos = outPos;
+        g.srcStart = srcStart;
+        g.readSpan = speed * (float) (grainInSamples - 1);
+        g.level = getGrainLevel (g.readSpan / (float) grainOutSamples);
+        g.exponent = 0.62f + 0.32f * jitter;
+        g.reverse = reverse;
+        g.leftGain = gain * std::sqrt (1.0f - grainPan);
+        g.rightGain = gain * std::sqrt (grainPan);
+        g.drive = 0.9f + 1.4f * grainBrightness;
+        g.lfoCycles = 1.5f + 3.0f * grainBrightness;
+        grains.push_back (g);
+    }
+
+    RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated, (juce::int64) (grains.capacity() * sizeof (Grain)));
+
+    // Grains that read faster than the host rate read a band-limited copy of the burst instead.
+    const auto decimated = makeGrainSources (micro, microRate, grains, profile, monitor);
+    if (isCancelled (monitor))
+        return out;
+
+    // Each output tile renders the grains starting inside it into a scratch buffer long enough for
+    // their tails, and the tiles are added into out in order, so the sum is the same on any number
+    // of threads.
+    const auto shapes = GrainShapes::get (grainOutSamples);
+    const int numTiles = (outSamples + granularTileSamples - 1) / granularTileSamples;
+    const int scratchSamples = granularTileSamples + grainOutSamples;
+
+    const auto firstGrainAt = [&] (int sample)
+    {
+        return (int) (std::lower_bound (grains.begin(), grains.end(), sample,
+                                        [] (const Grain& g, int pos) { return g.outPos < pos; }) - grains.begin());
+    };
+
+    runTileWaves (workers, numTiles, scratchSamples, monitor,
+                  [&] (int tile, juce::AudioBuffer<float>& target)
+                  {
+                      const int tileStart = tile * granularTileSamples;
+                      const int last = firstGrainAt (tileStart + granularTileSamples);
+
+                      for (int i = firstGrainAt (tileStart); i < last; ++i)
+                          renderGrain (*shapes, grains[(size_t) i], micro, decimated, target, tileStart, outSamples);
+                  },
+                  [&] (int tile, const juce::AudioBuffer<float>& scratch)
+                  {
+                      const int tileStart = tile * granularTileSamples;
+                      const int n = juce::jmin (scratchSamples, outSamples - tileStart);
+
+                      for (int ch = 0; ch < 2; ++ch)
+                          out.addFrom (ch, tileStart, scratch, ch, 0, n);
+                  });
+
+    RenderProfile::count (profile, RenderProfile::Counter::grainsScheduled, (juce::int64) grains.size());
+    countOutput (profile, out);
+    return out;
+}
+
+juce::AudioBuffer<float> RenderEngine::toMono (const juce::AudioBuffer<float>& in)
+{
+    juce::AudioBuffer<float> mono (1, in.getNumSamples());
+    mono.clear();
+
+    if (in.getNumChannels() == 1)
+    {
+        mono.copyFrom (0, 0, in, 0, 0, in.getNumSamples());
+        return mono;
+    }
+
+    mono.addFrom (0, 0, in, 0, 0, in.getNumSamples(), 0.5f);
+    mono.addFrom (0, 0, in, 1, 0, in.getNumSamples(), 0.5f);
+    return mono;
+}
+
+float RenderEngine::princArg (float x)
+{
+    return wrapPhase (x);
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldSpectral (const juce::AudioBuffer<float>& micro,
+                                                       double microRate,
+                                                       double outRate,
+                                                       double outSeconds,
+                                                       float stretch,
+                                                       float spectralWarp,
+                                                       float spectralChaos,
+                                                       int fftSize,
+                                                       float spectralFloorDb,
+                                                       int seed,
+                                                       const RenderMonitor* monitor) const
+{
+    const auto format = getSpectralTapFormat (micro.getNumSamples(), microRate, outRate);
+    return unfoldSpectralTap (decimateMicroBurst (micro, microRate, format.rate, format.numSamples),
+                              outRate, outSeconds, stretch, spectralWarp, spectralChaos, fftSize, spectralFloorDb, seed, monitor);
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldSpectralTap (const juce::AudioBuffer<float>& tap,
+                                                          double outRate,
+                                                          double outSeconds,
+                                                          float stretch,
+                                                          float spectralWarp,
+                                                          float spectralChaos,
+                                                          int fftSize,
+                                                          float spectralFloorDb,
+                                                          int seed,
+                                                          const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "spectral");
+
+    if (fftSize > 0)
+    {
+        auto out = unfoldSpectralBand (tap, outRate, outSeconds, stretch, spectralWarp, spectralChaos,
+                                       getFFTOrder (fftSize), 0.0, 0.0, spectralFloorDb, seed, monitor);
+        countOutput (profile, out);
+        return out;
+    }
+
+    // Multi-resolution: each band is unfolded on its own at its FFT size, then they are summed.
+    std::array<juce::AudioBuffer<float>, multiResolutionBands.size()> bands;
+
+    TaskGraph graph;
+    for (size_t b = 0; b < bands.size(); ++b)
+    {
+        graph.add ([&, b]
+        {
+            const auto& band = multiResolutionBands[b];
+            bands[b] = unfoldSpectralBand (tap, outRate, outSeconds, stretch, spectralWarp, spectralChaos,
+                                           band.order, band.lowHz, band.highHz, spectralFloorDb, seed, monitor);
+        });
+    }
+    graph.run (workers);
+
+    auto out = std::move (bands[0]);
+    for (size_t b = 1; b < bands.size(); ++b)
+        for (int ch = 0; ch < 2; ++ch)
+            out.addFrom (ch, 0, bands[b], ch, 0, out.getNumSamples());
+
+    countOutput (profile, out);
+    return out;
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldSpectralBand (const juce::AudioBuffer<float>& tap,
+                                                           double outRate,
+                                                           double outSeconds,
+                                                           float stretch,
+                                                           float spectralWarp,
+                                                           float spectralChaos,
+                                                           int fftOrder,
+                                                           double lowHz,
+                                                           double highHz,
+                                                           float spectralFloorDb,
+                                                           int seed,
+                                                           const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+
+    juce::Random rng (seed);
+    const float chaos = juce::jlimit (0.0f, 1.0f, spectralChaos);
+    const float chaos2 = chaos * chaos;
+
+    const int tinyOutSamples = tap.getNumSamples();
+
+    const int outSamples = juce::jmax (1, (int) std::round (outSeconds * outRate));
+    juce::AudioBuffer<float> out (2, outSamples);
+    out.clear();
+
+    const auto plan = FFTPlan::get (fftOrder);
+    const auto& window = plan->window;
+    const int fftSize = plan->size;
+    const int bins = fftSize / 2 + 1;
+
+    const int hopIn = juce::jmax (32, fftSize / 8);
+    const int hopOut = juce::jmax (32, (int) std::round ((double) hopIn * stretch));
+
+    const int numFrames = 1 + juce::jmax (0, (outSamples - fftSize) / hopOut);
+
+    // Analysis frames start hopIn apart, wrapped to the decimated burst, so they repeat with this period.
+    const int analysisPeriod = tinyOutSamples / std::gcd (hopIn, tinyOutSamples);
+    const auto analysis = getSpectralAnalysis (cache, workers, monitor, tap, *plan, hopIn, juce::jmin (numFrames, analysisPeriod));
+
+    const float seedPhaseA = rng.nextFloat() * twoPi;
+    const float seedPhaseB = rng.nextFloat() * twoPi;
+    const float seedPhaseC = rng.nextFloat() * twoPi;
+
+    std::vector<float> normK ((size_t) bins), logNormK ((size_t) bins);
+
+    for (int k = 0; k < bins; ++k)
+    {
+        normK[(size_t) k] = (float) k / (float) juce::jmax (1, bins - 1);
+        logNormK[(size_t) k] = k > 0 ? std::log (normK[(size_t) k]) : -1.0e4f; // so u^e flushes to zero
+    }
+
+    std::vector<float> bandWeight;
+
+    if (lowHz > 0.0 || highHz > 0.0)
+    {
+        bandWeight.resize ((size_t) bins);
+        for (int k = 0; k < bins; ++k)
+            bandWeight[(size_t) k] = getBandWeight ((double) k * outRate / (double) fftSize, lowHz, highHz);
+    }
+
+    const auto getFrame = [&] (int frame)
+    {
+        SpectralFrame f;
+        f.chaos = chaos;
+        f.chaos2 = chaos2;
+        f.frameU = (float) frame / (float) juce::jmax (1, numFrames - 1);
+        f.dynWarp = juce::jlimit (0.45f,
+                                  7.5f,
+                                  spectralWarp
+                                      * (1.0f
+                                          + (0.08f + 0.30f * chaos) * std::sin (twoPi * (0.23f * f.frameU) + seedPhaseA)
+                                          + (0.04f + 0.12f * chaos) * std::sin (twoPi * (0.97f * f.frameU) + seedPhaseB)));
+        f.srcExponent = juce::jmax (0.2f, 1.15f / f.dynWarp);
+        f.tiltAmount = (0.15f + 0.75f * chaos) * std::sin (twoPi * (0.31f * f.frameU) + seedPhaseA);
+        f.combDepth = 0.08f + 0.38f * chaos;
+        f.combCycles = 18.0f + (30.0f + 44.0f * chaos) * f.dynWarp;
+        f.combOffset = (0.06f + 0.31f * f.frameU) * (float) frame;
+        f.formantBase = 0.85f - 0.20f * chaos;
+        f.formantA = 0.13f + 0.24f * (0.5f + 0.5f * std::sin (twoPi * (0.21f * f.frameU) + seedPhaseA));
+        f.formantB = 0.36f + 0.27f * (0.5f + 0.5f * std::sin (twoPi * (0.34f * f.frameU) + seedPhaseB));
+        f.formantC = 0.64f + 0.21f * (0.5f + 0.5f * std::sin (twoPi * (0.18f * f.frameU) + seedPhaseC));
+        f.formantGainA = 0.20f + 0.62f * chaos;
+        f.formantGainB = 0.26f + 0.80f * chaos;
+        f.formantGainC = 0.22f + 0.66f * chaos;
+        f.formantScaleA = -0.5f / (0.032f * 0.032f);
+        f.formantScaleB = -0.5f / (0.045f * 0.045f);
+        f.formantScaleC = -0.5f / (0.055f * 0.055f);
+        f.stereoOffsetTurns = 0.07f * (float) frame + seedPhaseB / twoPi;
+        f.shimmer = (0.03f + 0.07f * chaos) + (0.10f + 0.20f * chaos)
+            * (0.5f + 0.5f * std::sin (twoPi * (1.07f * f.frameU) + seedPhaseC));
+        f.shimmerPhaseScale = (1.08f + 0.55f * chaos) + (0.1f + 0.95f * chaos) * f.frameU;
+        f.shimmerRotateRe = 0.97f * std::cos (0.13f);
+        f.shimmerRotateIm = 0.97f * std::sin (0.13f);
+        f.harmonicRatio = (1.08f + 0.45f * chaos) + (0.08f + 0.76f * chaos) * std::sin (twoPi * f.frameU + seedPhaseC);
+        return f;
+    };
+
+    // Frames are processed in blocks, in three passes each: reading and shaping every frame's
+    // spectrum from the shared analysis in parallel, then the phase vocoder's running sums over the
+    // block's frames in order (the only part that carries from frame to frame), then synthesis and
+    // overlap-add in parallel, in tiles of a few frames merged in order. Block and tile sizes depend
+    // only on the FFT size, so the output does not depend on the thread count. Per-bin quantities live in one array
+    // each (a row per frame), so that all but the gather from the input spectrum, the phase
+    // differences and the scatter into the output ones run as plain vectorizable loops.
+    constexpr int tileFrames = 4;
+    const int blockFrames = juce::jmax (tileFrames, (1 << 18) / fftSize);
+
+    const auto rowsSize = (size_t) blockFrames * (size_t) bins;
+    std::vector<float> srcPos (rowsSize), mag (rowsSize), phase (rowsSize), rateR (rowsSize), stereoOffset (rowsSize);
+    std::vector<double> sumL (rowsSize), sumR (rowsSize);
+    std::vector<float> lastPhase ((size_t) bins, 0.0f);
+
+    // The running phases grow by up to pi hopOut rad a frame. Summed in float, their rounding error
+    // soon reaches radians and differs between any two renders whose per-frame phases differ at all,
+    // so they are summed in double.
+    std::vector<double> sumPhaseL ((size_t) bins, 0.0), sumPhaseR ((size_t) bins, 0.0);
+
+    const int tileSamples = (tileFrames - 1) * hopOut + fftSize;
+
+    // With a spectral floor, each frame only synthesizes the bins at or above it, gathered into a
+    // compact run first so the polar conversions stay vectorized. The phase sums above are still
+    // kept for every bin, so a bin that rises above the floor later resumes exactly where the full
+    // synthesis would have it.
+    const bool sparse = spectralFloorDb < 0.0f;
+    const float floorGain = juce::Decibels::decibelsToGain (spectralFloorDb, -400.0f);
+    std::vector<int> allBins ((size_t) bins);
+    std::iota (allBins.begin(), allBins.end(), 0);
+
+    RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated,
+                          (juce::int64) (5 * rowsSize + 3 * (size_t) bins) * (juce::int64) sizeof (float)
+                            + (juce::int64) (2 * rowsSize + 2 * (size_t) bins) * (juce::int64) sizeof (double));
+
+    for (int blockStart = 0; blockStart < numFrames; blockStart += blockFrames)
+    {
+        if (isCancelled (monitor))
+            break;
+
+        const int framesInBlock = juce::jmin (blockFrames, numFrames - blockStart);
+        const auto row = [&] (auto& rows, int frame) { return rows.data() + (size_t) (frame - blockStart) * (size_t) bins; };
+
+        TaskGraph shapeFrames;
+        for (int groupStart = blockStart; groupStart < blockStart + framesInBlock; groupStart += tileFrames)
+        {
+            shapeFrames.add ([&, groupStart]
+            {
+                std::vector<float> shaping ((size_t) bins), binRe ((size_t) bins), binIm ((size_t) bins);
+
+                for (int frame = groupStart; frame < juce::jmin (groupStart + tileFrames, blockStart + framesInBlock); ++frame)
+                {
+                    auto* frameSrcPos = row (srcPos, frame);
+                    auto* frameMag = row (mag, frame);
+                    auto* framePhase = row (phase, frame);
+                    const auto* specIn = reinterpret_cast<const std::complex<float>*> (analysis->getReadPointer (frame % analysisPeriod));
+
+                    buildSpectralCurves (getFrame (frame), bins, normK.data(), logNormK.data(),
+                                         frameSrcPos, shaping.data(), row (stereoOffset, frame), row (rateR, frame));
+
+                    if (! bandWeight.empty())
+                        juce::FloatVectorOperations::multiply (shaping.data(), bandWeight.data(), bins);
+
+                    for (int k = 0; k < bins; ++k)
+                    {
+                        const int srcK0 = juce::jlimit (0, bins - 1, (int) frameSrcPos[k]);
+                        const int srcK1 = juce::jmin (bins - 1, srcK0 + 1);
+                        const float srcFrac = frameSrcPos[k] - (float) srcK0;
+                        const auto v = specIn[(size_t) srcK0] + (specIn[(size_t) srcK1] - specIn[(size_t) srcK0]) * srcFrac;
+                        binRe[(size_t) k] = v.real();
+                        binIm[(size_t) k] = v.imag();
+                    }
+
+                    for (int k = 0; k < bins; ++k)
+                    {
+                        const float re = binRe[(size_t) k], im = binIm[(size_t) k];
+                        frameMag[k] = std::sqrt (re * re + im * im) * shaping[(size_t) k];
+                        framePhase[k] = fastAtan2 (im, re);
+                    }
+                }
+            });
+        }
+        shapeFrames.run (workers);
+
+        RenderProfile::count (profile, RenderProfile::Counter::fftFrames, framesInBlock);
+
+        for (int frame = blockStart; frame < blockStart + framesInBlock; ++frame)
+        {
+            const auto* frameSrcPos = row (srcPos, frame);
+            const auto* frameRateR = row (rateR, frame);
+            auto* framePhase = row (phase, frame);
+
+            // Bins can read the same source bin, so the phase differences are taken in bin order.
+            // Each replaces its bin's phase, which is not needed after this.
+            for (int k = 0; k < bins; ++k)
+            {
+                const int srcK0 = juce::jlimit (0, bins - 1, (int) frameSrcPos[k]);
+                const float expected = twoPi * (float) hopIn * frameSrcPos[k] / (float) fftSize;
+                const float delta = framePhase[k] - lastPhase[(size_t) srcK0] - expected;
+                lastPhase[(size_t) srcK0] = framePhase[k];
+                framePhase[k] = delta;
+            }
+
+            for (int k = 0; k < bins; ++k)
+            {
+                const float freq = twoPi * frameSrcPos[k] / (float) fftSize + wrapPhase (framePhase[k]) / (float) hopIn;
+                sumPhaseL[(size_t) k] += (double) (freq * (float) hopOut);
+                sumPhaseR[(size_t) k] += (double) (freq * (float) hopOut * frameRateR[k]);
+            }
+
+            std::copy (sumPhaseL.begin(), sumPhaseL.end(), row (sumL, frame));
+            std::copy (sumPhaseR.begin(), sumPhaseR.end(), row (sumR, frame));
+        }
+
+        const int numTiles = (framesInBlock + tileFrames - 1) / tileFrames;
+
+        const auto synthesizeTile = [&] (int tile, juce::AudioBuffer<float>& target)
+        {
+            const auto& fft = plan->getTransform();
+            std::vector<float> directLRe ((size_t) bins), directLIm ((size_t) bins), directRRe ((size_t) bins), directRIm ((size_t) bins);
+            std::vector<float> shimmerLRe ((size_t) bins), shimmerLIm ((size_t) bins), shimmerRRe ((size_t) bins), shimmerRIm ((size_t) bins);
+            std::vector<std::complex<float>> specOutL ((size_t) bins), specOutR ((size_t) bins);
+            std::vector<std::complex<float>> mirroredL ((size_t) bins), mirroredR ((size_t) bins);
+            std::vector<std::complex<float>> packed ((size_t) fftSize), timeOut ((size_t) fftSize);
+            std::vector<int> activeBins;
+            std::vector<float> activeNormK, activeMag, activeStereoOffset;
+            std::vector<double> activeSumL, activeSumR;
+
+            if (sparse)
+            {
+                for (auto* v : { &activeNormK, &activeMag, &activeStereoOffset })
+                    v->resize ((size_t) bins);
+
+                activeSumL.resize ((size_t) bins);
+                activeSumR.resize ((size_t) bins);
+                activeBins.resize ((size_t) bins);
+            }
+
+            const int firstFrame = blockStart + tile * tileFrames;
+            const int endFrame = juce::jmin (firstFrame + tileFrames, blockStart + framesInBlock);
+            juce::int64 binsSynthesized = 0;
+
+            for (int frame = firstFrame; frame < endFrame; ++frame)
+            {
+                const auto f = getFrame (frame);
+                const int* binIndex = allBins.data();
+                const float* binNormK = normK.data();
+                const float* binMag = row (mag, frame);
+                const double* binSumL = row (sumL, frame);
+                const double* binSumR = row (sumR, frame);
+                const float* binStereoOffset = row (stereoOffset, frame);
+                int numActive = bins;
+
+                if (sparse)
+                {
+                    const float floor = floorGain * juce::FloatVectorOperations::findMaximum (binMag, bins);
+                    numActive = 0;
+
+                    for (int k = 0; k < bins; ++k)
+                    {
+                        if (binMag[k] > floor)
+                        {
+                            const auto a = (size_t) numActive++;
+                            activeBins[a] = k;
+                            activeNormK[a] = binNormK[k];
+                            activeMag[a] = binMag[k];
+                            activeSumL[a] = binSumL[k];
+                            activeSumR[a] = binSumR[k];
+                            activeStereoOffset[a] = binStereoOffset[k];
+                        }
+                    }
+
+                    binIndex = activeBins.data();
+                    binNormK = activeNormK.data();
+                    binMag = activeMag.data();
+                    binSumL = activeSumL.data();
+                    binSumR = activeSumR.data();
+                    binStereoOffset = activeStereoOffset.data();
+                }
+
+                binsSynthesized += numActive;
+
+                synthesizeSpectralBins (f, numActive, binNormK, binMag, binSumL, binSumR, binStereoOffset,
+                                        directLRe.data(), directLIm.data(), directRRe.data(), directRIm.data(),
+                                        shimmerLRe.data(), shimmerLIm.data(), shimmerRRe.data(), shimmerRIm.data());
+
+                std::fill (specOutL.begin(), specOutL.end(), std::complex<float> { 0.0f, 0.0f });
+                std::fill (specOutR.begin(), specOutR.end(), std::complex<float> { 0.0f, 0.0f });
+
+                for (int k = 0, a = 0; k < bins; ++k)
+                {
+                    if (a < numActive && binIndex[a] == k)
+                    {
+                        specOutL[(size_t) k] += std::complex<float> { directLRe[(size_t) a], directLIm[(size_t) a] };
+                        specOutR[(size_t) k] += std::complex<float> { directRRe[(size_t) a], directRIm[(size_t) a] };
+
+                        const int harmonicK = juce::jlimit (0, bins - 1, (int) std::round ((float) k * f.harmonicRatio));
+                        if (harmonicK > 0)
+                        {
+                            specOutL[(size_t) harmonicK] += std::complex<float> { shimmerLRe[(size_t) a], shimmerLIm[(size_t) a] };
+                            specOutR[(size_t) harmonicK] += std::complex<float> { shimmerRRe[(size_t) a], shimmerRIm[(size_t) a] };
+                        }
+
+                        ++a;
+                    }
+
+                    // What the negative-frequency bin is given, as of now: shimmer added to a
+                    // lower bin later on only reaches the positive side.
+                    mirroredL[(size_t) k] = specOutL[(size_t) k];
+                    mirroredR[(size_t) k] = specOutR[(size_t) k];
+                }
+
+                // Only the real part of each channel's inverse is used, which is the inverse of the
+                // conjugate-symmetric part of its spectrum, so L and R can share one complex transform.
+                const auto j = std::complex<float> { 0.0f, 1.0f };
+                packed[0] = { specOutL[0].real(), specOutR[0].real() };
+                packed[(size_t) (fftSize / 2)] = { specOutL[(size_t) (fftSize / 2)].real(), specOutR[(size_t) (fftSize / 2)].real() };
+
+                for (int k = 1; k < fftSize / 2; ++k)
+                {
+                    const auto l = 0.5f * (specOutL[(size_t) k] + mirroredL[(size_t) k]);
+                    const auto r = 0.5f * (specOutR[(size_t) k] + mirroredR[(size_t) k]);
+                    packed[(size_t) k] = l + j * r;
+                    packed[(size_t) (fftSize - k)] = std::conj (l) + j * std::conj (r);
+                }
+
+                fft.perform (packed.data(), timeOut.data(), true);
+
+                const int offset = (frame - firstFrame) * hopOut;
+                auto* outL = target.getWritePointer (0, offset);
+                auto* outR = target.getWritePointer (1, offset);
+
+                for (int n = 0; n < fftSize; ++n)
+                {
+                    const float win = window[(size_t) n] / (float) referenceFFTSize;
+                    outL[n] += timeOut[(size_t) n].real() * win;
+                    outR[n] += timeOut[(size_t) n].imag() * win;
+                }
+            }
+
+            RenderProfile::count (profile, RenderProfile::Counter::binsSynthesized, binsSynthesized);
+            RenderProfile::count (profile, RenderProfile::Counter::binsSkipped, (juce::int64) (endFrame - firstFrame) * bins - binsSynthesized);
+        };
+
+        const auto mergeTile = [&] (int tile, const juce::AudioBuffer<float>& scratch)
+        {
+            const int tileStart = (blockStart + tile * tileFrames) * hopOut;
+            const int n = juce::jmin (tileSamples, outSamples - tileStart);
+
+            for (int ch = 0; ch < 2; ++ch)
+                out.addFrom (ch, tileStart, scratch, ch, 0, n);
+        };
+
+        if (! runTileWaves (workers, numTiles, tileSamples, monitor, synthesizeTile, mergeTile))
+            break;
+    }
+
+    return out;
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldMorphogen (const juce::AudioBuffer<float>& micro,
+                                                        double microRate,
+                                                        double outRate,
+                                                        double outSeconds,
+                                                        float stretch,
+                                                        float spectralWarp,
+                                                        float spectralChaos,
+                                                        float hybridMix,
+                                                        int fftSize,
+                                                        int synthesis,
+                                                        int numBins,
+                                                        int field,
+                                                        int numCells,
+                                                        int seed,
+                                                        const RenderMonitor* monitor) const
+{
+    const auto format = getMorphogenTapFormat (micro.getNumSamples(), microRate, fftSize);
+    return unfoldMorphogenTap (decimateMicroBurst (micro, microRate, format.rate, format.numSamples), outRate, outSeconds,
+                               stretch, spectralWarp, spectralChaos, hybridMix, fftSize, synthesis, numBins, field, numCells, seed, monitor);
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldMorphogenTap (const juce::AudioBuffer<float>& tap,
+                                                           double outRate,
+                                                           double outSeconds,
+                                                           float stretch,
+                                                           float spectralWarp,
+                                                           float spectralChaos,
+                                                           float hybridMix,
+                                                           int fftSize,
+                                                           int synthesis,
+                                                           int numBins,
+                                                           int field,
+                                                           int numCells,
+                                                           int seed,
+                                                           const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "morphogen");
+
+    juce::Random rng (seed + 2026);
+    const float chaos = juce::jlimit (0.0f, 1.0f, spectralChaos);
+
+    const int outSamples = juce::jmax (1, (int) std::round (outSeconds * outRate));
+    juce::AudioBuffer<float> out (2, outSamples);
+    out.clear();
+
+    const int bins = numBins > 0 ? juce::jlimit (16, maxMorphogenBins, numBins)
+                                 : juce::jlimit (48, 160, (int) std::round (64.0f + 64.0f * chaos));
+    const int requestedCells = numCells > 0 ? juce::jlimit (16, maxMorphogenCells, numCells)
+                                            : juce::jlimit (40, 420, (int) std::round ((18.0f + 3.0f * stretch) * (1.0f + 0.6f * chaos)));
+    const int timeCells = field == morphogenPlane ? juce::jmin (requestedCells, maxMorphogenPlaneCells / bins) : requestedCells;
+    const int subSteps = juce::jlimit (2, 14, (int) std::round (3.0f + 8.0f * chaos));
+    const float baseWarp = juce::jlimit (0.6f, 6.0f, spectralWarp);
+
+    std::vector<float> specProfile ((size_t) bins, 0.0f);
+    std::vector<float> grid ((size_t) bins * (size_t) timeCells, 0.0f);
+
+    // Build a spectral seed profile from tiny windows of the micro burst.
+    const auto plan = FFTPlan::get (getMorphogenSeedOrder (fftSize));
+    const int seedFrameSize = plan->size;
+    jassert (tap.getNumSamples() == seedFrameSize);
+
+    // The tap is the whole burst band-limited and resampled to exactly one frame; it is windowed
+    // and transformed in place.
+    std::vector<float> seedFrame ((size_t) (2 * seedFrameSize));
+    std::copy (tap.getReadPointer (0), tap.getReadPointer (0) + seedFrameSize, seedFrame.begin());
+
+    juce::FloatVectorOperations::multiply (seedFrame.data(), plan->window.data(), seedFrameSize);
+    plan->getTransform().performRealOnlyForwardTransform (seedFrame.data(), true);
+    const auto* specBuf = reinterpret_cast<const std::complex<float>*> (seedFrame.data());
+    RenderProfile::count (profile, RenderProfile::Counter::fftFrames, 1);
+    RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated, (juce::int64) sizeof (float) * bins * (7 + timeCells));
+
+    // A dense burst's magnitudes grow about with the square root of the frame size; the gain was set at 1024.
+    const float profileGain = 6.0f * std::sqrt (1024.0f / (float) seedFrameSize);
+
+    for (int k = 0; k < bins; ++k)
+    {
+        const float u = (float) k / (float) juce::jmax (1, bins - 1);
+        const int src = juce::jlimit (0, seedFrameSize / 2, (int) std::round (u * (seedFrameSize / 2)));
+        specProfile[(size_t) k] = std::pow (juce::jlimit (0.0f, 1.0f, std::abs (specBuf[(size_t) src]) * profileGain), 0.65f);
+    }
+
+    const float diffUBase = 0.10f + 0.16f * chaos;
+    const float diffVBase = 0.06f + 0.12f * chaos;
+    const float temporalCouple = 0.08f + 0.26f * hybridMix;
+    const float fBase = 0.012f + 0.028f * chaos;
+    const float kBase = 0.038f + 0.034f * (1.0f - chaos);
+
+    const auto feedAt = [&] (int t)
+    {
+        const float tu = (float) t / (float) juce::jmax (1, timeCells - 1);
+        return fBase + 0.018f * std::sin (twoPi * (0.13f * tu + 0.71f * chaos));
+    };
+
+    const auto killAt = [&] (int t)
+    {
+        const float tu = (float) t / (float) juce::jmax (1, timeCells - 1);
+        return kBase + 0.016f * std::sin (twoPi * (0.21f * tu + 0.37f * chaos));
+    };
+
+    {
+        const RenderProfile::ScopedSpan diffusionSpan (profile, "reaction-diffusion");
+
+        if (field == morphogenPlane)
+        {
+            // Time runs down the rows and frequency along them. Each row has a ghost cell at either end,
+            // as frequency wraps like the ring's, and there is a ghost row above and below, copies of
+            // the edge rows so that nothing flows out through the ends of time. Coupling between
+            // neighbouring time cells stands in for the ring's pull towards its previous state, kept
+            // within the explicit step's stability limit. Each step reads only the previous one, so its
+            // rows run in parallel bands.
+            const int stride = bins + 2;
+            const size_t planeSize = (size_t) stride * (size_t) (timeCells + 2);
+            std::vector<float> planeU (planeSize, 1.0f), planeV (planeSize, 0.0f), nextU (planeSize, 1.0f), nextV (planeSize, 0.0f);
+            std::vector<ReactionRates> rowRates ((size_t) timeCells);
+            RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated, (juce::int64) (4 * planeSize * sizeof (float)));
+
+            for (int t = 0; t < timeCells; ++t)
+            {
+                rowRates[(size_t) t] = { diffUBase, diffVBase, 0.8f * temporalCouple, feedAt (t), killAt (t) };
+                float* u = planeU.data() + (size_t) (t + 1) * (size_t) stride + 1;
+                float* v = planeV.data() + (size_t) (t + 1) * (size_t) stride + 1;
+
+                for (int k = 0; k < bins; ++k)
+                {
+                    const float impulse = (rng.nextFloat() < (0.06f + 0.08f * chaos)) ? (0.4f + 0.6f * rng.nextFloat()) : 0.0f;
+                    v[k] = juce::jlimit (0.0f, 1.0f, 0.45f * specProfile[(size_t) k] + impulse);
+                    u[k] = 1.0f - v[k] * (0.6f + 0.3f * chaos);
+                }
+            }
+
+            const auto fillGhostCells = [&] (float* row)
+            {
+                row[0] = row[bins];
+                row[bins + 1] = row[1];
+            };
+
+            const auto fillGhostRows = [&] (std::vector<float>& plane)
+            {
+                std::copy_n (plane.data() + stride, stride, plane.data());
+                std::copy_n (plane.data() + (size_t) timeCells * (size_t) stride, stride, plane.data() + (size_t) (timeCells + 1) * (size_t) stride);
+            };
+
+            for (int t = 1; t <= timeCells; ++t)
+            {
+                fillGhostCells (planeU.data() + (size_t) t * (size_t) stride);
+                fillGhostCells (planeV.data() + (size_t) t * (size_t) stride);
+            }
+
+            fillGhostRows (planeU);
+            fillGhostRows (planeV);
+
+            const int planeSteps = 16 * subSteps;
+            const int rowsPerTask = juce::jmax (1, 16384 / bins);
+            RenderProfile::count (profile, RenderProfile::Counter::reactionDiffusionSteps, planeSteps);
+
+            for (int step = 0; step < planeSteps; ++step)
+            {
+                if (isCancelled (monitor))
+                    break;
+
+                const float* u = planeU.data();
+                const float* v = planeV.data();
+                float* nu = nextU.data();
+                float* nv = nextV.data();
+
+                TaskGraph graph;
+                for (int first = 0; first < timeCells; first += rowsPerTask)
+                {
+                    graph.add ([&, first]
+                    {
+                        const juce::ScopedNoDenormals noDenormals;
+
+                        for (int t = first; t < juce::jmin (first + rowsPerTask, timeCells); ++t)
+                        {
+                            const auto row = (size_t) (t + 1) * (size_t) stride;
+                            stepReactionDiffusionRow (rowRates[(size_t) t], bins,
+                                                      u + row - stride + 1, u + row + 1, u + row + stride + 1,
+                                                      v + row - stride + 1, v + row + 1, v + row + stride + 1,
+                                                      nu + row + 1, nv + row + 1);
+                            fillGhostCells (nu + row);
+                            fillGhostCells (nv + row);
+                        }
+                    });
+                }
+                graph.run (workers);
+
+                fillGhostRows (nextU);
+                fillGhostRows (nextV);
+                planeU.swap (nextU);
+                planeV.swap (nextV);
+            }
+
+            for (int t = 0; t < timeCells; ++t)
+            {
+                const float* v = planeV.data() + (size_t) (t + 1) * (size_t) stride + 1;
+
+                for (int k = 0; k < bins; ++k)
+                    grid[(size_t) t * (size_t) bins + (size_t) k] = juce::jlimit (0.0f, 1.0f, v[k] * (0.7f + 0.6f * specProfile[(size_t) k]));
+            }
+        }
+        else
+        {
+            // The ring's cells are at 1 to bins, with a ghost cell at either end holding the cell
+            // across the wrap, so the stencil needs no modulo. Over many steps V decays into
+            // denormals, which would slow the stepping tenfold, so they are flushed to zero (as in
+            // the plane's row tasks, so that either is the same however the render is threaded).
+            const juce::ScopedNoDenormals noDenormals;
+            std::vector<float> rdU ((size_t) bins + 2, 1.0f), rdV ((size_t) bins + 2, 0.0f), prevU ((size_t) bins, 1.0f), prevV ((size_t) bins, 0.0f);
+            std::vector<float> nextU ((size_t) bins + 2, 1.0f), nextV ((size_t) bins + 2, 0.0f);
+
+            for (int k = 0; k < bins; ++k)
+            {
+                const float impulse = (rng.nextFloat() < (0.06f + 0.08f * chaos)) ? (0.4f + 0.6f * rng.nextFloat()) : 0.0f;
+                rdV[(size_t) k + 1] = juce::jlimit (0.0f, 1.0f, 0.45f * specProfile[(size_t) k] + impulse);
+                rdU[(size_t) k + 1] = 1.0f - rdV[(size_t) k + 1] * (0.6f + 0.3f * chaos);
+                prevU[(size_t) k] = rdU[(size_t) k + 1];
+                prevV[(size_t) k] = rdV[(size_t) k + 1];
+            }
+
+            RenderProfile::count (profile, RenderProfile::Counter::reactionDiffusionSteps, (juce::int64) timeCells * subSteps);
+
+            for (int t = 0; t < timeCells; ++t)
+            {
+                const float f = feedAt (t);
+                const float kk = killAt (t);
+
+                for (int step = 0; step < subSteps; ++step)
+                {
+                    for (auto* ring : { &rdU, &rdV })
+                    {
+                        (*ring)[0] = (*ring)[(size_t) bins];
+                        (*ring)[(size_t) bins + 1] = (*ring)[1];
+                    }
+
+                    const float* ringU = rdU.data() + 1;
+                    const float* ringV = rdV.data() + 1;
+
+                    for (int k = 0; k < bins; ++k)
+                    {
+                        const float u = ringU[k];
+                        const float v = ringV[k];
+                        const float lapU = ringU[k - 1] - 2.0f * u + ringU[k + 1];
+                        const float lapV = ringV[k - 1] - 2.0f * v + ringV[k + 1];
+                        const float temporalU = prevU[(size_t) k] - u;
+                        const float temporalV = prevV[(size_t) k] - v;
+
+                        const float du = (diffUBase * lapU) - (u * v * v) + f * (1.0f - u) + temporalCouple * temporalU;
+                        const float dv = (diffVBase * lapV) + (u * v * v) - (kk + f) * v + temporalCouple * temporalV;
+
+                        nextU[(size_t) k + 1] = juce::jlimit (0.0f, 1.5f, u + du * 0.9f);
+                        nextV[(size_t) k + 1] = juce::jlimit (0.0f, 1.5f, v + dv * 0.9f);
+                    }
+
+                    rdU.swap (nextU);
+                    rdV.swap (nextV);
+                }
+
+                for (int k = 0; k < bins; ++k)
+                {
+                    const float c = juce::jlimit (0.0f, 1.0f, rdV[(size_t) k + 1] * (0.7f + 0.6f * specProfile[(size_t) k]));
+                    grid[(size_t) t * (size_t) bins + (size_t) k] = c;
+                    prevU[(size_t) k] = rdU[(size_t) k + 1];
+                    prevV[(size_t) k] = rdV[(size_t) k + 1];
+                }
+            }
+        }
+    }
+
+    const float nyquist = 0.5f * (float) outRate;
+    const float warpPow = juce::jlimit (0.35f, 2.8f, 1.0f / juce::jmax (0.15f, baseWarp));
+    const float stereoSpread = 0.02f + 0.28f * hybridMix + 0.2f * chaos;
+    const float harmonicSkew = 0.15f + 0.6f * chaos;
+
+    if (synthesis == morphogenIFFT)
+    {
+        // The same oscillator bank, resynthesized a short frame at a time: each partial goes into the
+        // frame's spectrum as a window lobe at its frequency, with its amplitude and phase at the
+        // frame's centre, and the inverse transforms overlap-add. The oscillators' phases have closed
+        // forms, so frames are independent and render in parallel tiles. A partial holds its frequency
+        // across a frame, so frames are kept short (256 points at 44.1 kHz) for the right channel's
+        // detune wobble, a 44 Hz vibrato, to be followed closely.
+        const auto kernel = AdditiveKernel::get (juce::jlimit (7, AdditiveKernel::maxOrder, juce::roundToInt (std::log2 (256.0 * outRate / 44100.0))));
+        const auto synthesisPlan = FFTPlan::get (kernel->order);
+        const int frameSize = kernel->size;
+        const int hop = frameSize / 4;
+        const int numPartials = bins - 1;
+        const int numFrames = outSamples / hop + 2;     // frame j covers samples (j - 1) hop to (j + 1) hop
+        constexpr int tileFrames = 32;
+        const int numTiles = (numFrames + tileFrames - 1) / tileFrames;
+        const int tileSamples = (tileFrames + 1) * hop;
+
+        // Per partial: left and right phase rates in turns per sample, the left's frequency in frame
+        // bins, half its level (the other half goes to the mirrored bins) and its wobble offset.
+        std::vector<double> rateL ((size_t) numPartials), rateR ((size_t) numPartials);
+        std::vector<float> binL ((size_t) numPartials), level ((size_t) numPartials), wobbleTurns ((size_t) numPartials);
+
+        for (int i = 0; i < numPartials; ++i)
+        {
+            const float ku = (float) (i + 1) / (float) juce::jmax (1, bins - 1);
+            const float freq = juce::jlimit (12.0f, nyquist * 0.98f, std::pow (ku, warpPow) * nyquist);
+            rateL[(size_t) i] = (double) (freq * (1.0f + harmonicSkew * ku)) / outRate;
+            rateR[(size_t) i] = (double) (freq * (1.0f - harmonicSkew * (1.0f - ku))) / outRate;
+            binL[(size_t) i] = (float) (rateL[(size_t) i] * frameSize);
+            level[(size_t) i] = 0.5f * (0.10f + 0.16f * chaos) * std::pow (1.0f - ku, 0.35f + 0.25f * chaos);
+            wobbleTurns[(size_t) i] = ku * 3.0f;
+        }
+
+        RenderProfile::count (profile, RenderProfile::Counter::bytesAllocated, (juce::int64) numPartials * (juce::int64) (2 * sizeof (double) + 3 * sizeof (float)));
+        RenderProfile::count (profile, RenderProfile::Counter::fftFrames, numFrames);
+
+        // The detune is 1 + spread (1 + sin (2 pi (s / 1000 + wobble))) / 2 at sample s; its running sum
+        // from sample 0 is a sum of sines in arithmetic progression.
+        const double wobbleRate = 0.001;
+        const double halfSpread = 0.5 * stereoSpread;
+        const double wobbleSumScale = halfSpread / std::sin (juce::MathConstants<double>::pi * wobbleRate);
+
+        const auto synthesizeTile = [&] (int tile, juce::AudioBuffer<float>& target)
+        {
+            const auto& fft = synthesisPlan->getTransform();
+            const int mask = frameSize - 1;
+            std::vector<float> reL ((size_t) numPartials), imL ((size_t) numPartials);
+            std::vector<float> binR ((size_t) numPartials), reR ((size_t) numPartials), imR ((size_t) numPartials);
+            std::vector<double> turnsR ((size_t) numPartials);
+            std::vector<std::complex<float>> lobesL ((size_t) frameSize), lobesR ((size_t) frameSize);
+            std::vector<std::complex<float>> spectrum ((size_t) frameSize), timeOut ((size_t) frameSize);
+
+            const int firstFrame = tile * tileFrames;
+
+            for (int frame = firstFrame; frame < juce::jmin (firstFrame + tileFrames, numFrames); ++frame)
+            {
+                const int centre = frame * hop;
+                const float tu = (float) juce::jmin (centre, outSamples - 1) / (float) juce::jmax (1, outSamples - 1);
+                const float cellPos = tu * (float) juce::jmax (1, timeCells - 1);
+                const int t0 = juce::jlimit (0, timeCells - 1, (int) cellPos);
+                const int t1 = juce::jmin (timeCells - 1, t0 + 1);
+                const float tf = cellPos - (float) t0;
+                const float* row0 = grid.data() + (size_t) t0 * (size_t) bins + 1;
+                const float* row1 = grid.data() + (size_t) t1 * (size_t) bins + 1;
+
+                // The oscillators advance before they are read, so sample s is at phase (s + 1) rate.
+                const double elapsed = (double) centre + 1.0;
+                const double wobbleSum = wobbleSumScale * std::sin (juce::MathConstants<double>::pi * wobbleRate * elapsed);
+
+                for (int i = 0; i < numPartials; ++i)
+                {
+                    const float amp = level[(size_t) i] * juce::jlimit (0.0f, 1.0f, juce::jmap (tf, row0[i], row1[i]));
+                    const double turns = elapsed * rateL[(size_t) i];
+                    reL[(size_t) i] = amp * sinTurns (turns);
+                    imL[(size_t) i] = -amp * sinTurns (turns + 0.25);
+                }
+
+                const double sumBase = elapsed * (1.0 + halfSpread);
+                const double wobbleNow = wobbleRate * (double) centre;
+                const float spread = stereoSpread;
+
+                for (int i = 0; i < numPartials; ++i)
+                {
+                    const double wobble = (double) wobbleTurns[(size_t) i];
+                    const float detune = 1.0f + spread * (0.5f + 0.5f * sinTurns (wobble + wobbleNow));
+                    turnsR[(size_t) i] = (sumBase + wobbleSum * sinTurns (wobble + 0.5 * wobbleNow)) * rateR[(size_t) i];
+                    binR[(size_t) i] = (float) (rateR[(size_t) i] * frameSize) * detune;
+                }
+
+                for (int i = 0; i < numPartials; ++i)
+                {
+                    const float amp = level[(size_t) i] * juce::jlimit (0.0f, 1.0f, juce::jmap (tf, row0[i], row1[i]));
+                    reR[(size_t) i] = amp * sinTurns (turnsR[(size_t) i]);
+                    imR[(size_t) i] = -amp * sinTurns (turnsR[(size_t) i] + 0.25);
+                }
+
+                std::fill (lobesL.begin(), lobesL.end(), std::complex<float> { 0.0f, 0.0f });
+                std::fill (lobesR.begin(), lobesR.end(), std::complex<float> { 0.0f, 0.0f });
+                addAdditiveLobes (*kernel, numPartials, binL.data(), reL.data(), imL.data(), lobesL.data());
+                addAdditiveLobes (*kernel, numPartials, binR.data(), reR.data(), imR.data(), lobesR.data());
+
+                // Both channels are real, so they share one complex transform, R as the imaginary part.
+                for (int k = 0; k < frameSize; ++k)
+                {
+                    const auto l = lobesL[(size_t) k] + std::conj (lobesL[(size_t) (-k & mask)]);
+                    const auto r = lobesR[(size_t) k] + std::conj (lobesR[(size_t) (-k & mask)]);
+                    spectrum[(size_t) k] = l + std::complex<float> { 0.0f, 1.0f } * r;
+                }
+
+                fft.perform (spectrum.data(), timeOut.data(), true);
+
+                auto* outL = target.getWritePointer (0, (frame - firstFrame) * hop);
+                auto* outR = target.getWritePointer (1, (frame - firstFrame) * hop);
+
+                for (int n = 0; n < frameSize / 2; ++n)
+                {
+                    const auto v = timeOut[(size_t) ((n - frameSize / 4) & mask)];
+                    outL[n] += v.real() * kernel->postWindow[(size_t) n];
+                    outR[n] += v.imag() * kernel->postWindow[(size_t) n];
+                }
+            }
+        };
+
+        const auto mergeTile = [&] (int tile, const juce::AudioBuffer<float>& scratch)
+        {
+            const int tileStart = (tile * tileFrames - 1) * hop;
+            const int begin = juce::jmax (0, -tileStart);
+            const int end = juce::jmin (tileSamples, outSamples - tileStart);
+
+            for (int ch = 0; ch < 2 && end > begin; ++ch)
+                out.addFrom (ch, tileStart + begin, scratch, ch, begin, end - begin);
+        };
+
+        runTileWaves (workers, numTiles, tileSamples, monitor, synthesizeTile, mergeTile);
+        countOutput (profile, out);
+        return out;
+    }
+
+    std::vector<float> phaseL ((size_t) bins, 0.0f), phaseR ((size_t) bins, 0.0f);
+
+    for (int s = 0; s < outSamples; ++s)
+    {
+        if ((s & 1023) == 0 && isCancelled (monitor))
+            break;
+
+        const float tu = (float) s / (float) juce::jmax (1, outSamples - 1);
+        const float cellPos = tu * (float) juce::jmax (1, timeCells - 1);
+        const int t0 = juce::jlimit (0, timeCells - 1, (int) cellPos);
+        const int t1 = juce::jmin (timeCells - 1, t0 + 1);
+        const float tf = cellPos - (float) t0;
+
+        float sampleL = 0.0f;
+        float sampleR = 0.0f;
+
+        for (int k = 1; k < bins; ++k)
+        {
+            const float ku = (float) k / (float) juce::jmax (1, bins - 1);
+            const float amp0 = grid[(size_t) t0 * (size_t) bins + (size_t) k];
+            const float amp1 = grid[(size_t) t1 * (size_t) bins + (size_t) k];
+            const float amp = juce::jlimit (0.0f, 1.0f, juce::jmap (tf, amp0, amp1));
+
+            const float warped = std::pow (ku, warpPow);
+            const float freq = juce::jlimit (12.0f, nyquist * 0.98f, warped * nyquist);
+            const float detune = 1.0f + stereoSpread * (0.5f + 0.5f * std::sin (twoPi * (0.001f * (float) s + ku * 3.0f)));
+
+            phaseL[(size_t) k] += twoPi * freq / (float) outRate;
+            phaseR[(size_t) k] += twoPi * (freq * detune) / (float) outRate;
+
+            const float morph = std::sin (phaseL[(size_t) k] * (1.0f + harmonicSkew * ku));
+            const float morphR = std::sin (phaseR[(size_t) k] * (1.0f - harmonicSkew * (1.0f - ku)));
+            const float w = std::pow (1.0f - ku, 0.35f + 0.25f * chaos);
+            sampleL += amp * w * morph;
+            sampleR += amp * w * morphR;
+        }
+
+        out.setSample (0, s, sampleL * (0.10f + 0.16f * chaos));
+        out.setSample (1, s, sampleR * (0.10f + 0.16f * chaos));
+    }
+
+    countOutput (profile, out);
+    return out;
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldFennesz (const juce::AudioBuffer<float>& spectral,
+                                                      const juce::AudioBuffer<float>& granular,
+                                                      double outRate,
+                                                      float spectralChaos,
+                                                      float hybridMix,
+                                                      int seed,
+                                                      const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "fennesz");
+
+    const int outSamples = juce::jmax (spectral.getNumSamples(), granular.getNumSamples());
+    juce::AudioBuffer<float> out (2, outSamples);
+    out.clear();
+    juce::Random rng (seed + 3003);
+
+    float phaseA = 0.0f, phaseB = 0.0f, phaseC = 0.0f;
+    const float chordA = 110.0f * (1.0f + 0.08f * (rng.nextFloat() - 0.5f));
+    const float chordB = chordA * 1.4983f;
+    const float chordC = chordA * 2.2449f;
+
+    const int d1 = juce::jmax (1, (int) std::round (outRate * (0.033 + 0.021 * spectralChaos)));
+    const int d2 = juce::jmax (1, (int) std::round (outRate * (0.071 + 0.029 * spectralChaos)));
+    std::vector<float> dl ((size_t) outSamples, 0.0f), dr ((size_t) outSamples, 0.0f);
+
+    for (int i = 0; i < outSamples; ++i)
+    {
+        const float t = (float) i / (float) juce::jmax (1, outSamples - 1);
+        const float env = 0.25f + 0.75f * std::pow (0.5f - 0.5f * std::cos (twoPi * t), 0.55f);
+        const float flutter = 1.0f + 0.008f * std::sin (twoPi * (0.11f * t + 0.03f * spectralChaos));
+        phaseA += twoPi * (chordA * flutter) / (float) outRate;
+        phaseB += twoPi * (chordB * flutter) / (float) outRate;
+        phaseC += twoPi * (chordC * flutter) / (float) outRate;
+        const float drone = 0.35f * std::sin (phaseA) + 0.22f * std::sin (phaseB) + 0.18f * std::sin (phaseC);
+        const float hiss = (rng.nextFloat() * 2.0f - 1.0f) * (0.01f + 0.05f * spectralChaos);
+
+        const float sL = i < spectral.getNumSamples() ? spectral.getSample (0, i) : 0.0f;
+        const float sR = i < spectral.getNumSamples() ? spectral.getSample (1, i) : 0.0f;
+        const float gL = i < granular.getNumSamples() ? granular.getSample (0, i) : 0.0f;
+        const float gR = i < granular.getNumSamples() ? granular.getSample (1, i) : 0.0f;
+        float xL = 0.46f * sL + 0.36f * gL + env * (0.20f * drone + hiss);
+        float xR = 0.46f * sR + 0.36f * gR + env * (0.20f * drone - hiss);
+
+        const int i1 = i - d1, i2 = i - d2;
+        const float fbL = (i1 >= 0 ? dl[(size_t) i1] : 0.0f) * 0.34f + (i2 >= 0 ? dr[(size_t) i2] : 0.0f) * 0.21f;
+        const float fbR = (i1 >= 0 ? dr[(size_t) i1] : 0.0f) * 0.34f + (i2 >= 0 ? dl[(size_t) i2] : 0.0f) * 0.21f;
+        dl[(size_t) i] = std::tanh (xL + fbL * (0.35f + 0.28f * hybridMix));
+        dr[(size_t) i] = std::tanh (xR + fbR * (0.35f + 0.28f * hybridMix));
+
+        out.setSample (0, i, dl[(size_t) i] * 0.76f);
+        out.setSample (1, i, dr[(size_t) i] * 0.76f);
+    }
+
+    countOutput (profile, out);
+    return out;
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldNoto (const juce::AudioBuffer<float>& micro,
+                                                   double microRate,
+                                                   double outRate,
+                                                   double outSeconds,
+                                                   float stretch,
+                                                   float spectralWarp,
+                                                   float spectralChaos,
+                                                   int seed,
+                                                   const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "noto");
+
+    juce::ignoreUnused (microRate, spectralWarp);
+    const int outSamples = juce::jmax (1, (int) std::round (outRate * outSeconds));
+    juce::AudioBuffer<float> out (2, outSamples);
+    out.clear();
+
+    juce::Random rng (seed + 4004);
+    auto mono = toMono (micro);
+    uint32_t lfsr = (uint32_t) seed ^ 0xA5366B4Du;
+    const int grid = juce::jmax (12, (int) std::round (outRate * (0.007 + 0.018 * (1.0f - juce::jlimit (0.0f, 1.0f, spectralChaos)))));
+    const int microN = juce::jmax (1, mono.getNumSamples());
+    float phase = 0.0f;
+    const float baseHz = 200.0f + 3000.0f * juce::jlimit (0.0f, 1.0f, spectralChaos);
+
+    for (int i = 0; i < outSamples; ++i)
+    {
+        if (i % grid == 0)
+        {
+            const uint32_t bit = ((lfsr >> 0u) ^ (lfsr >> 2u) ^ (lfsr >> 3u) ^ (lfsr >> 5u)) & 1u;
+            lfsr = (lfsr >> 1u) | (bit << 31u);
+        }
+
+        const bool gateA = ((lfsr >> 2u) & 1u) != 0u;
+        const bool gateB = ((lfsr >> 9u) & 1u) != 0u;
+        const float sub = (float) (i % grid) / (float) juce::jmax (1, grid - 1);
+        const float clickEnv = std::exp (-22.0f * sub) * (gateA ? 1.0f : 0.0f);
+        const float burstEnv = std::exp (-8.0f * sub) * (gateB ? 1.0f : 0.0f);
+
+        const float hz = baseHz * (1.0f + 2.0f * (float) ((lfsr >> 16u) & 7u) / 7.0f);
+        phase += twoPi * hz / (float) outRate;
+        const float sine = std::sin (phase);
+
+        const int mi = (int) ((i * (3 + (seed % 11))) % microN);
+        const float microTap = mono.getSample (0, mi);
+        const float click = (rng.nextFloat() * 2.0f - 1.0f) * clickEnv * (0.12f + 0.18f * spectralChaos);
+        const float body = burstEnv * (0.18f * sine + 0.12f * std::tanh (4.0f * microTap));
+        const float sparse = ((i % (grid * (2 + (int) std::round (stretch * 0.2f)))) == 0) ? 0.6f : 0.0f;
+
+        const float left = click + body + sparse * (rng.nextFloat() * 2.0f - 1.0f) * 0.08f;
+        const float right = -click + body - sparse * (rng.nextFloat() * 2.0f - 1.0f) * 0.08f;
+        out.setSample (0, i, left);
+        out.setSample (1, i, right);
+    }
+
+    countOutput (profile, out);
+    return out;
+}
+
+juce::AudioBuffer<float> RenderEngine::unfoldIkeda (const juce::AudioBuffer<float>& micro,
+                                                    double microRate,
+                                                    double outRate,
+                                                    double outSeconds,
+                                                    float stretch,
+                                                    float spectralWarp,
+                                                    float spectralChaos,
+                                                    int seed,
+                                                    const RenderMonitor* monitor) const
+{
+    auto* profile = profileOf (monitor);
+    const RenderProfile::ScopedSpan span (profile, "ikeda");
+
+    juce::ignoreUnused (microRate);
+    const int outSamples = juce::jmax (1, (int) std::round (outRate * outSeconds));
+    juce::AudioBuffer<float> out (2, outSamples);
+    out.clear();
+
+    auto mono = toMono (micro);
+    const int microN = juce::jmax (1, mono.getNumSamples());
+    const float chaos = juce::jlimit (0.0f, 1.0f, spectralChaos);
+    const int banks = 6 + (int) std::round (10.0f * chaos);
+    std::vector<float> freq ((size_t) banks, 0.0f), phase ((size_t) banks, 0.0f);
+    uint32_t state = ((uint32_t) seed) ^ 0x7F4A7C15u;
+
+    for (int b = 0; b < banks; ++b)
+    {
+        const float step = 40.0f + 220.0f * (float) b;
+        const float quant = std::pow (2.0f, std::floor (std::log2 (step * juce::jlimit (0.5f, 6.0f, spectralWarp))));
+        freq[(size_t) b] = juce::jlimit (20.0f, (float) (0.48 * outRate), quant);
+    }
+
+    const int gatePeriod = juce::jmax (2, (int) std::round (outRate * (0.0009 + 0.006 * (1.0f - chaos))));
+    const int macro = juce::jmax (8, (int) std::round (outRate * (0.03 + 0.18 * (stretch / 100.0f))));
+
+    for (int i = 0; i < outSamples; ++i)
+    {
+        if (i % gatePeriod == 0)
+        {
+            const uint32_t bit = ((state >> 0u) ^ (state >> 1u) ^ (state >> 21u) ^ (state >> 31u)) & 1u;
+            state = (state >> 1u) | (bit << 31u);
+        }
+
+        float l = 0.0f, r = 0.0f;
+        const float macroEnv = (((i / macro) & 1) == 0) ? 1.0f : (0.14f + 0.22f * chaos);
+        for (int b = 0; b < banks; ++b)
+        {
+            const bool gate = ((state >> (b % 31)) & 1u) != 0u;
+            phase[(size_t) b] += twoPi * freq[(size_t) b] / (float) outRate;
+            const float s = std::sin (phase[(size_t) b]) * (gate ? 1.0f : 0.0f);
+            const float w = 1.0f / (1.0f + (float) b * 0.35f);
+            l += s * w;
+            r += ((b & 1) == 0 ? s : -s) * w;
+        }
+
+        const int mi = (i * (5 + (seed % 13))) % microN;
+        const float data = std::tanh (mono.getSample (0, mi) * (8.0f + 18.0f * chaos));
+        const float amp = macroEnv * (0.05f + 0.35f * chaos);
+        out.setSample (0, i, std::tanh ((l * amp) + data * 0.08f));
+        out.setSample (1, i, std::tanh ((r * amp) - data * 0.08f));
+    }
+
+    countOutput (profile, out);
+    return out;
+}
+
+void RenderEngine::applyBloomInPlace (juce::AudioBuffer<float>& b,
+                                      double sampleRate,
+                                      int seed,
+                                      float amount)
+{
+    if (b.getNumSamples() <= 8 || b.getNumChannels() < 2)
+        return;
+
+    juce::Random rng (seed);
+    const int n = b.getNumSamples();
+    const float amt = juce::jlimit (0.0f, 1.0f, amount);
+
+    const int tap1 = juce::jmax (1, (int) std::round ((0.013 + 0.018 * rng.nextFloat()) * sampleRate));
+    const int tap2 = juce::jmax (1, (int) std::round ((0.029 + 0.031 * rng.nextFloat()) * sampleRate));
+    const int tap3 = juce::jmax (1, (int) std::round ((0.061 + 0.045 * rng.nextFloat()) * sampleRate));
+    const int tap4 = juce::jmax (1, (int) std::round ((0.101 + 0.071 * rng.nextFloat()) * sampleRate));
+
+    std::vector<float> dL ((size_t) n, 0.0f), dR ((size_t) n, 0.0f);
+    float hpL = 0.0f, hpR = 0.0f, lpL = 0.0f, lpR = 0.0f;
+    const float hpCoeff = 0.987f;
+    const float lpCoeff = 0.08f + 0.10f * amt;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const float inL = b.getSample (0, i);
+        const float inR = b.getSample (1, i);
+
+        const int i1 = i - tap1, i2 = i - tap2, i3 = i - tap3, i4 = i - tap4;
+        const float fbL = (i1 >= 0 ? dR[(size_t) i1] : 0.0f) * 0.41f
+                        + (i2 >= 0 ? dL[(size_t) i2] : 0.0f) * 0.29f
+                        - (i3 >= 0 ? dR[(size_t) i3] : 0.0f) * 0.18f
+                        + (i4 >= 0 ? dL[(size_t) i4] : 0.0f) * 0.13f;
+        const float fbR = (i1 >= 0 ? dL[(size_t) i1] : 0.0f) * 0.41f
+                        + (i2 >= 0 ? dR[(size_t) i2] : 0.0f) * 0.29f
+                        - (i3 >= 0 ? dL[(size_t) i3] : 0.0f) * 0.18f
+                        + (i4 >= 0 ? dR[(size_t) i4] : 0.0f) * 0.13f;
+
+        dL[(size_t) i] = std::tanh (inL + fbL * (0.28f + 0.42f * amt));
+        dR[(size_t) i] = std::tanh (inR + fbR * (0.28f + 0.42f * amt));
+
+        const float mid = 0.5f * (dL[(size_t) i] + dR[(size_t) i]);
+        hpL = hpCoeff * (hpL + dL[(size_t) i] - mid);
+        hpR = hpCoeff * (hpR + dR[(size_t) i] - mid);
+
+        lpL += lpCoeff * (hpL - lpL);
+        lpR += lpCoeff * (hpR - lpR);
+
+        b.addSample (0, i, lpL * (0.11f + 0.28f * amt));
+        b.addSample (1, i, lpR * (0.11f + 0.28f * amt));
+    }
+}
+
+void RenderEngine::sanitizeBufferInPlace (juce::AudioBuffer<float>& b)
+{
+    for (int ch = 0; ch < b.getNumChannels(); ++ch)
+    {
+        auto* x = b.getWritePointer (ch);
+        for (int i = 0; i < b.getNumSamples(); ++i)
+        {
+            float s = x[i];
+            if (! std::isfinite (s))
+                s = 0.0f;
+
+            // Keep pathological values bounded before normalization.
+            x[i] = std::tanh (s * 0.7f) * 1.35f;
+        }
+    }
+}
+
+void RenderEngine::normalizeInPlace (juce::AudioBuffer<float>& b, float peakTarget)
+{
+    float peak = 0.0f;
+    for (int ch = 0; ch < b.getNumChannels(); ++ch)
+        peak = juce::jmax (peak, b.getMagnitude (ch, 0, b.getNumSamples()));
+
+    if (peak > 1.0e-7f)
+        b.applyGain (peakTarget / peak);
+}
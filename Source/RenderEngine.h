@@ -0,0 +1,305 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "RenderCache.h"
+#include "RenderProfile.h"
+#include "TaskGraph.h"
+
+// Plain snapshot of everything a render depends on. Built from the plugin's parameters,
+// a preset or a batch file; the engine never sees where it came from.
+struct RenderRequest
+{
+    int mode = 0;
+    double microRate = 768000.0;
+    double outRate = 44100.0;
+    float burstMs = 24.0f;
+    int density = 6000;
+    float outSeconds = 6.0f;
+    float grainMs = 42.0f;
+    float overlap = 6.0f;
+    float stretch = 18.0f;
+    float warp = 1.7f;
+    float spectralChaos = 0.45f;
+    float hybridMix = 0.5f;
+    int seed = 12345;
+    int fftSize = 2048;   // spectral analysis size in points, 256 to 16384; 0 for multi-resolution
+    float spectralFloorDb = 0.0f;   // spectral bins this far below their frame's peak are not synthesized; 0 keeps all
+    int morphogenSynth = 0;   // Morphogen's partials: 0 runs each as an oscillator, 1 resynthesizes them by inverse FFT
+    int morphogenBins = 0;    // Morphogen partials, 16 to 4096; 0 picks 48 to 160 from spectralChaos
+    int morphogenField = 0;   // Morphogen's reaction-diffusion: 0 steps a ring of bins through time, 1 a time x frequency plane
+    int morphogenCells = 0;   // Morphogen time cells, 16 to 4096; 0 picks 40 to 420 from stretch and spectralChaos
+};
+
+// The events of one micro burst as parallel arrays, one entry per event in generation order.
+// Frequencies are in Hz at microRate. An additive event's partial detunes are
+// detunes[detuneOffset[i] .. detuneOffset[i] + partials[i]).
+struct MicroEventTable
+{
+    enum EventType : juce::uint8
+    {
+        chirp,
+        fm,
+        additive,
+        noisyChirp
+    };
+
+    double microRate = 0.0;
+    int numSamples = 0;
+
+    std::vector<int> start, length;
+    std::vector<float> amp, pan, f0, f1, fmRate, fmDepth, noiseBlend;
+    std::vector<juce::uint8> type, partials;
+    std::vector<int> detuneOffset;
+    std::vector<float> detunes;
+    std::vector<juce::int64> noiseSeed;
+
+    int size() const noexcept { return (int) start.size(); }
+};
+
+struct RenderResult
+{
+    juce::AudioBuffer<float> buffer;
+    double sampleRate = 44100.0;
+    bool cancelled = false; // stopped by its monitor; the buffer should not be used
+
+    // The micro-burst events the render was unfolded from. Null if the whole render came from a
+    // cache that no longer holds them.
+    std::shared_ptr<const MicroEventTable> microEvents;
+};
+
+enum class RenderStage
+{
+    idle,
+    queued,
+    microBurst,
+    unfold,
+    bloom,
+    normalize,
+    finished
+};
+
+// Lets long renders report where they are and find out when they have been superseded.
+class RenderMonitor
+{
+public:
+    virtual ~RenderMonitor() = default;
+    virtual bool shouldCancel() const = 0;
+    virtual void reportProgress (RenderStage stage, float stageFraction) = 0;
+
+    // Where the stages record their timings and work counters, if anyone is listening.
+    virtual RenderProfile* getProfile() const { return nullptr; }
+};
+
+// One factory preset, in parameter terms (microRateChoice and beautyScene are choice indices).
+struct RenderPreset
+{
+    const char* name;
+    int mode;
+    int microRateChoice;
+    float burstMs;
+    int density;
+    float outSeconds;
+    float grainMs;
+    float overlap;
+    float stretch;
+    float warp;
+    float spectralChaos;
+    float hybridMix;
+    int seed;
+    int beautyScene;
+};
+
+// The offline DSP: a RenderRequest in, audio out. The engine holds no mutable state of its own,
+// so one instance can serve any number of renders at once. The optional cache and worker pool
+// are both thread-safe and may be shared between engines; without a pool, branches run inline.
+class RenderEngine
+{
+public:
+    explicit RenderEngine (RenderCache* cache = nullptr, juce::ThreadPool* workers = nullptr);
+
+    RenderResult render (const RenderRequest& request, RenderMonitor* monitor = nullptr) const;
+
+    // Upper bound for RenderRequest::density (micro-burst events). A burst's cost is about its event
+    // count times the longest event, which grows with the micro rate, so denser bursts are also held
+    // to maxMicroBurstWork event samples: about a million events at 192 kHz, 16000 at 12.288 MHz.
+    static constexpr int maxDensity = 1000000;
+    static constexpr double maxMicroBurstWork = 2.4e8;
+    static int getMaxDensity (double microRate);
+
+    // Sets one field from a parameter ID and its plain value, as used by the plugin and batch files,
+    // held to the plugin parameter's range. A microRate above 16 is taken as a rate in Hz rather than
+    // a choice index, and goes up to the nearest supported rate.
+    static bool setParameter (RenderRequest& request, const juce::String& paramID, float plainValue);
+    static double getMicroRateForChoice (int choice);
+    static int getMicroRateChoiceForRate (double rate);
+    static constexpr int numMicroRateChoices = 6;
+
+    // Choice 0 is multi-resolution (RenderRequest::fftSize 0), then powers of two from 256 to 16384.
+    // An fftSize parameter above 16 is taken as a size in points rather than a choice index.
+    static int getFFTSizeForChoice (int choice);
+    static constexpr int numFFTSizeChoices = 8;
+
+    // RenderRequest::morphogenSynth values.
+    static constexpr int morphogenOscillators = 0, morphogenIFFT = 1;
+    static constexpr int maxMorphogenBins = 4096;
+
+    // RenderRequest::morphogenField values.
+    static constexpr int morphogenRing = 0, morphogenPlane = 1;
+    static constexpr int maxMorphogenCells = 4096;
+
+    // The plane takes 32 to 224 explicit steps over every cell, so it is held to this many cells
+    // (partials x time cells) by giving it fewer time cells: at the cap, up to about 1 s on one core.
+    static constexpr int maxMorphogenPlaneCells = 1 << 21;
+
+    static int getNumPresets();
+    static const RenderPreset& getPreset (int index);
+    static RenderRequest makePresetRequest (int index, double outRate);
+
+    static juce::String getStageName (RenderStage stage);
+    static bool writeWav (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate);
+
+    // Receives consecutive finished stretches of a micro burst, in order: the first numSamples
+    // samples of tile are burst samples [startSample, startSample + numSamples).
+    using MicroTileConsumer = std::function<void (const juce::AudioBuffer<float>& tile, int startSample, int numSamples)>;
+
+    // The individual stages, so tools can drive or time them on their own. renderMicroBurst is
+    // makeMicroEvents followed by synthesizeMicroBurst. The streaming synthesizeMicroBurst keeps
+    // only a few tiles in memory and returns false if it was cancelled.
+    static MicroEventTable makeMicroEvents (double microRate, double burstMs, int density, const RenderMonitor* monitor = nullptr);
+    bool synthesizeMicroBurst (const MicroEventTable& events, const MicroTileConsumer& consumer, const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> synthesizeMicroBurst (const MicroEventTable& events, const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> renderMicroBurst (double microRate, double burstMs, int density, const RenderMonitor* monitor = nullptr) const;
+
+    // The micro burst mixed to mono and band-limited to numSamples samples at rate: all the spectral
+    // and Morphogen unfolds read of it. From an event table, the burst is synthesized tile by tile
+    // straight into the decimator and never held whole, so memory doesn't grow with the micro rate.
+    static juce::AudioBuffer<float> decimateMicroBurst (const juce::AudioBuffer<float>& micro, double microRate, double rate, int numSamples);
+    juce::AudioBuffer<float> decimateMicroBurst (const MicroEventTable& events, double rate, int numSamples, const RenderMonitor* monitor = nullptr) const;
+
+    juce::AudioBuffer<float> unfoldGranular (const juce::AudioBuffer<float>& micro,
+                                             double microRate,
+                                             double outRate,
+                                             double outSeconds,
+                                             float grainOutMs,
+                                             float overlap,
+                                             int seed,
+                                             const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> unfoldSpectral (const juce::AudioBuffer<float>& micro,
+                                             double microRate,
+                                             double outRate,
+                                             double outSeconds,
+                                             float stretch,
+                                             float spectralWarp,
+                                             float spectralChaos,
+                                             int fftSize,
+                                             float spectralFloorDb,
+                                             int seed,
+                                             const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> unfoldXeno (const juce::AudioBuffer<float>& spectral,
+                                         const juce::AudioBuffer<float>& granular,
+                                         double outRate,
+                                         float stretch,
+                                         float spectralWarp,
+                                         float spectralChaos,
+                                         float hybridMix,
+                                         int seed,
+                                         const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> unfoldMorphogen (const juce::AudioBuffer<float>& micro,
+                                              double microRate,
+                                              double outRate,
+                                              double outSeconds,
+                                              float stretch,
+                                              float spectralWarp,
+                                              float spectralChaos,
+                                              float hybridMix,
+                                              int fftSize,
+                                              int synthesis,
+                                              int numBins,
+                                              int field,
+                                              int numCells,
+                                              int seed,
+                                              const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> unfoldFennesz (const juce::AudioBuffer<float>& spectral,
+                                            const juce::AudioBuffer<float>& granular,
+                                            double outRate,
+                                            float spectralChaos,
+                                            float hybridMix,
+                                            int seed,
+                                            const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> unfoldNoto (const juce::AudioBuffer<float>& micro,
+                                         double microRate,
+                                         double outRate,
+                                         double outSeconds,
+                                         float stretch,
+                                         float spectralWarp,
+                                         float spectralChaos,
+                                         int seed,
+                                         const RenderMonitor* monitor = nullptr) const;
+    juce::AudioBuffer<float> unfoldIkeda (const juce::AudioBuffer<float>& micro,
+                                          double microRate,
+                                          double outRate,
+                                          double outSeconds,
+                                          float stretch,
+                                          float spectralWarp,
+                                          float spectralChaos,
+                                          int seed,
+                                          const RenderMonitor* monitor = nullptr) const;
+
+    static juce::AudioBuffer<float> toMono (const juce::AudioBuffer<float>& in);
+    static float princArg (float x);
+    static void sanitizeBufferInPlace (juce::AudioBuffer<float>& b);
+    static void applyBloomInPlace (juce::AudioBuffer<float>& b, double sampleRate, int seed, float amount);
+    static void normalizeInPlace (juce::AudioBuffer<float>& b, float peakTarget = 0.95f);
+
+private:
+    juce::AudioBuffer<float> renderStages (const RenderRequest& request, RenderMonitor* monitor,
+                                           std::shared_ptr<const MicroEventTable>& microEvents) const;
+
+    // unfoldSpectral and unfoldMorphogen proper, given the burst's decimated mono tap (see
+    // decimateMicroBurst) rather than the burst.
+    juce::AudioBuffer<float> unfoldSpectralTap (const juce::AudioBuffer<float>& tap,
+                                                double outRate,
+                                                double outSeconds,
+                                                float stretch,
+                                                float spectralWarp,
+                                                float spectralChaos,
+                                                int fftSize,
+                                                float spectralFloorDb,
+                                                int seed,
+                                                const RenderMonitor* monitor) const;
+    juce::AudioBuffer<float> unfoldMorphogenTap (const juce::AudioBuffer<float>& tap,
+                                                 double outRate,
+                                                 double outSeconds,
+                                                 float stretch,
+                                                 float spectralWarp,
+                                                 float spectralChaos,
+                                                 float hybridMix,
+                                                 int fftSize,
+                                                 int synthesis,
+                                                 int numBins,
+                                                 int field,
+                                                 int numCells,
+                                                 int seed,
+                                                 const RenderMonitor* monitor) const;
+
+    // The spectral unfold at one FFT order, keeping only output bins between lowHz and highHz (with
+    // crossovers into the neighbouring bands); a bound of 0 leaves that side open. With a negative
+    // spectralFloorDb, bins that far below their frame's peak skip synthesis.
+    juce::AudioBuffer<float> unfoldSpectralBand (const juce::AudioBuffer<float>& tap,
+                                                 double outRate,
+                                                 double outSeconds,
+                                                 float stretch,
+                                                 float spectralWarp,
+                                                 float spectralChaos,
+                                                 int fftOrder,
+                                                 double lowHz,
+                                                 double highHz,
+                                                 float spectralFloorDb,
+                                                 int seed,
+                                                 const RenderMonitor* monitor) const;
+
+    RenderCache* const cache;
+    juce::ThreadPool* const workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderEngine)
+};
@@ -0,0 +1,178 @@
+#include "RenderProfile.h"
+
+RenderProfile::RenderProfile()
+    : originMs (juce::Time::getMillisecondCounterHiRes())
+{
+}
+
+void RenderProfile::add (Counter counter, juce::int64 amount) noexcept
+{
+    counters[(size_t) counter].fetch_add (amount, std::memory_order_relaxed);
+}
+
+juce::int64 RenderProfile::get (Counter counter) const noexcept
+{
+    return counters[(size_t) counter].load (std::memory_order_relaxed);
+}
+
+double RenderProfile::now() const noexcept
+{
+    return juce::Time::getMillisecondCounterHiRes() - originMs;
+}
+
+void RenderProfile::addSpan (const juce::String& name, double startMs, double endMs)
+{
+    const auto threadId = juce::Thread::getCurrentThreadId();
+
+    const juce::ScopedLock sl (lock);
+    auto thread = threadIds.indexOf (threadId);
+
+    if (thread < 0)
+    {
+        thread = threadIds.size();
+        threadIds.add (threadId);
+
+        auto* current = juce::Thread::getCurrentThread();
+        threadNames.add (current != nullptr ? current->getThreadName() + " " + juce::String (thread) : juce::String ("caller"));
+    }
+
+    spans.push_back ({ name, thread, startMs, juce::jmax (0.0, endMs - startMs) });
+}
+
+std::vector<RenderProfile::Span> RenderProfile::getSpans() const
+{
+    const juce::ScopedLock sl (lock);
+    return spans;
+}
+
+juce::String RenderProfile::describeStages() const
+{
+    juce::StringArray names;
+    std::vector<double> totals;
+
+    for (const auto& s : getSpans())
+    {
+        auto index = names.indexOf (s.name);
+        if (index < 0)
+        {
+            index = names.size();
+            names.add (s.name);
+            totals.push_back (0.0);
+        }
+
+        totals[(size_t) index] += s.durationMs;
+    }
+
+    juce::StringArray parts;
+    for (int i = 0; i < names.size(); ++i)
+        parts.add (names[i] + " " + juce::String (juce::roundToInt (totals[(size_t) i])) + " ms");
+
+    return parts.joinIntoString (", ");
+}
+
+juce::String RenderProfile::describeCounters() const
+{
+    juce::StringArray parts;
+    for (size_t i = 0; i < numCounters; ++i)
+    {
+        const auto counter = (Counter) i;
+        const auto value = get (counter);
+
+        if (value == 0)
+            continue;
+
+        if (counter == Counter::bytesAllocated)
+            parts.add (juce::File::descriptionOfSizeInBytes (value) + " allocated");
+        else if (counter == Counter::binsSkipped)
+            parts.add (juce::String (value) + " " + getCounterName (counter) + " ("
+                       + juce::String (juce::roundToInt (100.0 * getSkippedBinFraction())) + "%)");
+        else
+            parts.add (juce::String (value) + " " + getCounterName (counter));
+    }
+
+    return parts.joinIntoString (", ");
+}
+
+double RenderProfile::getSkippedBinFraction() const noexcept
+{
+    const auto skipped = get (Counter::binsSkipped);
+    const auto total = skipped + get (Counter::binsSynthesized);
+    return total > 0 ? (double) skipped / (double) total : 0.0;
+}
+
+juce::var RenderProfile::toChromeTrace() const
+{
+    juce::Array<juce::var> events;
+    double endMs = 0.0;
+
+    auto event = [] (const juce::String& name, const char* phase, int tid)
+    {
+        auto* e = new juce::DynamicObject();
+        e->setProperty ("name", name);
+        e->setProperty ("ph", phase);
+        e->setProperty ("pid", 1);
+        e->setProperty ("tid", tid);
+        return e;
+    };
+
+    {
+        const juce::ScopedLock sl (lock);
+
+        for (int t = 0; t < threadNames.size(); ++t)
+        {
+            auto* args = new juce::DynamicObject();
+            args->setProperty ("name", threadNames[t]);
+
+            auto* e = event ("thread_name", "M", t);
+            e->setProperty ("args", juce::var (args));
+            events.add (juce::var (e));
+        }
+
+        for (const auto& s : spans)
+        {
+            auto* e = event (s.name, "X", s.thread);
+            e->setProperty ("cat", "render");
+            e->setProperty ("ts", s.startMs * 1000.0);
+            e->setProperty ("dur", s.durationMs * 1000.0);
+            events.add (juce::var (e));
+            endMs = juce::jmax (endMs, s.startMs + s.durationMs);
+        }
+    }
+
+    auto* counterArgs = new juce::DynamicObject();
+    for (size_t i = 0; i < numCounters; ++i)
+        counterArgs->setProperty (juce::Identifier (getCounterName ((Counter) i).replaceCharacter (' ', '_')), get ((Counter) i));
+
+    auto* c = event ("counters", "C", 0);
+    c->setProperty ("ts", endMs * 1000.0);
+    c->setProperty ("args", juce::var (counterArgs));
+    events.add (juce::var (c));
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty ("traceEvents", events);
+    root->setProperty ("displayTimeUnit", "ms");
+    return juce::var (root);
+}
+
+bool RenderProfile::writeChromeTrace (const juce::File& file) const
+{
+    return file.replaceWithText (juce::JSON::toString (toChromeTrace(), true));
+}
+
+juce::String RenderProfile::getCounterName (Counter counter)
+{
+    switch (counter)
+    {
+        case Counter::eventsSynthesized:      return "events";
+        case Counter::grainsScheduled:        return "grains";
+        case Counter::fftFrames:              return "FFT frames";
+        case Counter::binsSynthesized:        return "bins synthesized";
+        case Counter::binsSkipped:            return "bins skipped";
+        case Counter::reactionDiffusionSteps: return "RD steps";
+        case Counter::samplesWritten:         return "samples";
+        case Counter::bytesAllocated:         return "bytes";
+        case Counter::numCounters:            break;
+    }
+
+    return {};
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+// Timings and work counters for one render. Spans and counters may be added from any thread the
+// render runs on; spans are kept per thread so the trace shows parallel branches side by side.
+class RenderProfile
+{
+public:
+    enum class Counter
+    {
+        eventsSynthesized,
+        grainsScheduled,
+        fftFrames,
+        binsSynthesized,
+        binsSkipped,
+        reactionDiffusionSteps,
+        samplesWritten,
+        bytesAllocated,
+        numCounters
+    };
+
+    struct Span
+    {
+        juce::String name;
+        int thread = 0;
+        double startMs = 0.0;   // relative to the profile's creation
+        double durationMs = 0.0;
+    };
+
+    RenderProfile();
+
+    void add (Counter counter, juce::int64 amount) noexcept;
+    juce::int64 get (Counter counter) const noexcept;
+    void addSpan (const juce::String& name, double startMs, double endMs);
+    double now() const noexcept;
+
+    std::vector<Span> getSpans() const;
+
+    // Time per span name in order of first appearance, e.g. "micro burst 112 ms, spectral 640 ms".
+    juce::String describeStages() const;
+    juce::String describeCounters() const;
+
+    // Of the spectral bins considered for synthesis, the share skipped as inaudible (0 when none were).
+    double getSkippedBinFraction() const noexcept;
+
+    // Chrome / Perfetto trace-event JSON (load in chrome://tracing or ui.perfetto.dev).
+    juce::var toChromeTrace() const;
+    bool writeChromeTrace (const juce::File& file) const;
+
+    static juce::String getCounterName (Counter counter);
+
+    // Null-safe helpers, so instrumented code doesn't need to check whether anyone is profiling.
+    static void count (RenderProfile* profile, Counter counter, juce::int64 amount) noexcept
+    {
+        if (profile != nullptr)
+            profile->add (counter, amount);
+    }
+
+    class ScopedSpan
+    {
+    public:
+        ScopedSpan (RenderProfile* profileIn, const char* nameIn)
+            : profile (profileIn), name (nameIn), start (profileIn != nullptr ? profileIn->now() : 0.0)
+        {}
+
+        ~ScopedSpan()
+        {
+            if (profile != nullptr)
+                profile->addSpan (name, start, profile->now());
+        }
+
+    private:
+        RenderProfile* const profile;
+        const char* const name;
+        const double start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedSpan)
+    };
+
+private:
+    static constexpr size_t numCounters = (size_t) Counter::numCounters;
+
+    const double originMs;
+    std::array<std::atomic<juce::int64>, numCounters> counters {};
+
+    mutable juce::CriticalSection lock;
+    std::vector<Span> spans;
+    juce::Array<juce::Thread::ThreadID> threadIds;
+    juce::StringArray threadNames;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderProfile)
+};
@@ -0,0 +1,135 @@
+#include "TaskGraph.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+struct TaskGraph::State
+{
+    enum NodeState { waiting, submitted, claimed, done };
+
+    struct Node
+    {
+        std::function<void()> task;
+        std::vector<TaskId> dependents;
+        int pendingDependencies = 0;
+        std::atomic<int> nodeState { waiting };
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes;
+    std::mutex mutex;
+    juce::WaitableEvent progressed;
+    std::atomic<int> numDone { 0 };
+
+    bool claim (Node& n)
+    {
+        int expected = submitted;
+        return n.nodeState.compare_exchange_strong (expected, claimed);
+    }
+
+    // Only the first submission of a node counts, so it can never be queued or run twice.
+    void submit (const std::shared_ptr<State>& self, TaskId id, juce::ThreadPool* pool)
+    {
+        int expected = waiting;
+        if (! nodes[(size_t) id]->nodeState.compare_exchange_strong (expected, submitted))
+            return;
+
+        if (pool != nullptr)
+        {
+            std::weak_ptr<State> weak = self;
+            pool->addJob ([weak, id, pool]
+            {
+                // The graph may already have been run to completion by the caller.
+                if (auto s = weak.lock())
+                    if (s->claim (*s->nodes[(size_t) id]))
+                        s->execute (s, id, pool);
+            });
+        }
+
+        progressed.signal();
+    }
+
+    void execute (const std::shared_ptr<State>& self, TaskId id, juce::ThreadPool* pool)
+    {
+        auto& n = *nodes[(size_t) id];
+        n.task();
+
+        std::vector<TaskId> nowReady;
+        {
+            const std::lock_guard<std::mutex> lg (mutex);
+            n.nodeState = done;
+
+            for (auto d : n.dependents)
+                if (--nodes[(size_t) d]->pendingDependencies == 0)
+                    nowReady.push_back (d);
+        }
+
+        for (auto d : nowReady)
+            submit (self, d, pool);
+
+        ++numDone;
+        progressed.signal();
+    }
+};
+
+TaskGraph::TaskGraph()
+    : state (std::make_shared<State>())
+{
+}
+
+TaskGraph::~TaskGraph() = default;
+
+TaskGraph::TaskId TaskGraph::add (std::function<void()> task, std::initializer_list<TaskId> dependencies)
+{
+    const auto id = (TaskId) state->nodes.size();
+    auto node = std::make_unique<State::Node>();
+    node->task = std::move (task);
+
+    for (auto d : dependencies)
+    {
+        jassert (juce::isPositiveAndBelow (d, id));
+        state->nodes[(size_t) d]->dependents.push_back (id);
+        ++node->pendingDependencies;
+    }
+
+    state->nodes.push_back (std::move (node));
+    return id;
+}
+
+void TaskGraph::run (juce::ThreadPool* pool)
+{
+    const auto numTasks = (int) state->nodes.size();
+
+    // The roots are collected before any of them is submitted: once a task runs, the dependency
+    // counts it decrements are no longer safe to read here.
+    std::vector<TaskId> roots;
+    for (TaskId id = 0; id < numTasks; ++id)
+        if (state->nodes[(size_t) id]->pendingDependencies == 0)
+            roots.push_back (id);
+
+    for (auto id : roots)
+        state->submit (state, id, pool);
+
+    while (state->numDone.load() < numTasks)
+    {
+        bool ranSomething = false;
+
+        for (TaskId id = 0; id < numTasks; ++id)
+        {
+            if (state->claim (*state->nodes[(size_t) id]))
+            {
+                state->execute (state, id, pool);
+                ranSomething = true;
+            }
+        }
+
+        if (! ranSomething)
+            state->progressed.wait (20.0);
+    }
+}
+
+RenderWorkerPool::RenderWorkerPool()
+    : pool (juce::ThreadPoolOptions{}
+                .withThreadName ("unfoldings worker")
+                .withNumberOfThreads (juce::jmax (1, juce::SystemStats::getNumCpus())))
+{
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+#include <memory>
+
+// A tiny dependency graph of render tasks. Tasks whose dependencies are met are handed to a
+// thread pool; the calling thread works through whatever the pool has not picked up yet, so
+// run() never deadlocks even when it is itself called from a busy pool thread.
+// Each task writes only its own outputs, which keeps results independent of scheduling.
+class TaskGraph
+{
+public:
+    using TaskId = int;
+
+    TaskGraph();
+    ~TaskGraph();
+
+    TaskId add (std::function<void()> task, std::initializer_list<TaskId> dependencies = {});
+
+    // Runs every task and returns when they have all finished. A null pool runs everything inline.
+    void run (juce::ThreadPool* pool);
+
+private:
+    struct State;
+    std::shared_ptr<State> state;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TaskGraph)
+};
+
+// Process-wide pool shared by every render, so concurrent renders don't each spin up a core's worth of threads.
+struct RenderWorkerPool
+{
+    RenderWorkerPool();
+
+    juce::ThreadPool pool;
+};
@@ -0,0 +1,715 @@
+#include <JuceHeader.h>
+#include "Decimator.h"
+#include "FastMath.h"
+#include "RenderEngine.h"
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+// Determinism check: renders every preset and a sampled parameter grid, hashes each output and
+// compares the hashes against a stored reference.
+//
+//   unfoldings-verify [--reference <file.json>] [--threads <n,n,...>] [--audio <dir>]
+//                     [--max-abs <x>] [--min-snr <dB>] [--record] [--rate <Hz>]
+//
+// Every case is rendered once per worker-thread count (0 = inline), plus once through a stage cache.
+// A hash mismatch fails unless reference audio exists in --audio and the difference stays within
+// the given --max-abs / --min-snr; with neither given, only bit-exact output passes. --record
+// renders the cases with the first thread count and rewrites the reference (and the audio, when
+// --audio is given).
+// To compare instruction sets or compilers, build the tool each way and check against one reference.
+// Before any case is rendered, a few self-checks exercise the building blocks the renders rely on
+// (task scheduling, the fast math approximations, the decimator); if one fails, nothing is rendered or recorded.
+
+namespace
+{
+struct VerifyCase
+{
+    juce::String name;
+    RenderRequest request;
+    juce::String hash;   // reference hash, empty when recording
+};
+
+juce::String hashBuffer (const juce::AudioBuffer<float>& b)
+{
+    StageKey key;
+    key.add (b.getNumChannels()).add (b.getNumSamples());
+
+    for (int ch = 0; ch < b.getNumChannels(); ++ch)
+    {
+        const auto* x = b.getReadPointer (ch);
+        for (int i = 0; i < b.getNumSamples(); ++i)
+            key.add (x[i]);
+    }
+
+    return juce::String::toHexString ((juce::int64) key.get()).paddedLeft ('0', 16);
+}
+
+juce::var requestToVar (const RenderRequest& r)
+{
+    auto* o = new juce::DynamicObject();
+    o->setProperty ("mode", r.mode);
+    o->setProperty ("microRate", r.microRate);
+    o->setProperty ("outRate", r.outRate);
+    o->setProperty ("burstMs", r.burstMs);
+    o->setProperty ("density", r.density);
+    o->setProperty ("outSeconds", r.outSeconds);
+    o->setProperty ("grainMs", r.grainMs);
+    o->setProperty ("overlap", r.overlap);
+    o->setProperty ("stretch", r.stretch);
+    o->setProperty ("warp", r.warp);
+    o->setProperty ("spectralChaos", r.spectralChaos);
+    o->setProperty ("hybridMix", r.hybridMix);
+    o->setProperty ("seed", r.seed);
+    o->setProperty ("fftSize", r.fftSize);
+    o->setProperty ("spectralFloor", r.spectralFloorDb);
+    o->setProperty ("morphogenSynth", r.morphogenSynth);
+    o->setProperty ("morphogenBins", r.morphogenBins);
+    o->setProperty ("morphogenField", r.morphogenField);
+    o->setProperty ("morphogenCells", r.morphogenCells);
+    return juce::var (o);
+}
+
+RenderRequest requestFromVar (const juce::var& v)
+{
+    RenderRequest r;
+    if (auto* obj = v.getDynamicObject())
+        for (const auto& prop : obj->getProperties())
+            RenderEngine::setParameter (r, prop.name.toString(), (float) prop.value);
+
+    r.outRate = (double) v.getProperty ("outRate", r.outRate);
+    return r;
+}
+
+// Every preset, then a fixed pseudo-random sample of the parameter space, a few per mode, then the
+// FFT-based modes at a few analysis sizes and with sparse spectral synthesis, then Morphogen's
+// inverse-FFT resynthesis and its reaction-diffusion plane.
+std::vector<VerifyCase> makeCases (double outRate)
+{
+    std::vector<VerifyCase> cases;
+
+    for (int p = 0; p < RenderEngine::getNumPresets(); ++p)
+        cases.push_back ({ "preset " + juce::String (p).paddedLeft ('0', 2) + " " + RenderEngine::getPreset (p).name,
+                           RenderEngine::makePresetRequest (p, outRate), {} });
+
+    juce::Random rng (20240611);
+    for (int mode = 0; mode < 8; ++mode)
+    {
+        for (int n = 0; n < 4; ++n)
+        {
+            RenderRequest r;
+            r.mode = mode;
+            r.outRate = outRate;
+            r.microRate = RenderEngine::getMicroRateForChoice (rng.nextInt (4));
+            r.burstMs = juce::jmap (rng.nextFloat(), 5.0f, 80.0f);
+            r.density = 500 + rng.nextInt (29501);
+            r.outSeconds = juce::jmap (rng.nextFloat(), 1.0f, 4.0f);
+            r.grainMs = juce::jmap (rng.nextFloat(), 8.0f, 180.0f);
+            r.overlap = juce::jmap (rng.nextFloat(), 1.5f, 16.0f);
+            r.stretch = juce::jmap (rng.nextFloat(), 2.0f, 100.0f);
+            r.warp = juce::jmap (rng.nextFloat(), 0.5f, 6.0f);
+            r.spectralChaos = rng.nextFloat();
+            r.hybridMix = rng.nextFloat();
+            r.seed = 1 + rng.nextInt (999999);
+
+            cases.push_back ({ "grid m" + juce::String (mode) + " #" + juce::String (n), r, {} });
+        }
+    }
+
+    // The extended micro rates, unfolded from the streamed tap and from the whole burst, and a
+    // density past Event Density's range.
+    for (int choice : { 4, 5 })
+    {
+        for (int mode : { 1, 3 })
+        {
+            RenderRequest r;
+            r.mode = mode;
+            r.outRate = outRate;
+            r.microRate = RenderEngine::getMicroRateForChoice (choice);
+            r.outSeconds = 3.0f;
+
+            cases.push_back ({ "rate " + juce::String (r.microRate / 1.0e6, 3) + " MHz m" + juce::String (mode), r, {} });
+        }
+    }
+
+    for (int mode : { 0, 1 })
+    {
+        RenderRequest r;
+        r.mode = mode;
+        r.outRate = outRate;
+        r.microRate = RenderEngine::getMicroRateForChoice (0);
+        r.density = 120000;
+        r.outSeconds = 3.0f;
+
+        cases.push_back ({ "density 120000 m" + juce::String (mode), r, {} });
+    }
+
+    // The FFT-based modes at the ends of the analysis size range and at multi-resolution.
+    for (int fftSize : { 256, 16384, 0 })
+    {
+        for (int mode : { 1, 4, 5 })
+        {
+            RenderRequest r;
+            r.mode = mode;
+            r.outRate = outRate;
+            r.outSeconds = 3.0f;
+            r.fftSize = fftSize;
+
+            cases.push_back ({ "fft " + (fftSize > 0 ? juce::String (fftSize) : juce::String ("multi")) + " m" + juce::String (mode), r, {} });
+        }
+    }
+
+    // Sparse spectral synthesis, at the default size and at multi-resolution.
+    for (int fftSize : { 2048, 0 })
+    {
+        for (int mode : { 1, 5 })
+        {
+            RenderRequest r;
+            r.mode = mode;
+            r.outRate = outRate;
+            r.outSeconds = 3.0f;
+            r.fftSize = fftSize;
+            r.spectralFloorDb = -40.0f;
+
+            cases.push_back ({ "sparse " + (fftSize > 0 ? juce::String (fftSize) : juce::String ("multi")) + " m" + juce::String (mode), r, {} });
+        }
+    }
+
+    // Morphogen resynthesized by inverse FFT, at its automatic partial count and with thousands.
+    for (int bins : { 0, 4096 })
+    {
+        RenderRequest r;
+        r.mode = 4;
+        r.outRate = outRate;
+        r.outSeconds = 3.0f;
+        r.morphogenSynth = RenderEngine::morphogenIFFT;
+        r.morphogenBins = bins;
+
+        cases.push_back ({ "ifft " + (bins > 0 ? juce::String (bins) : juce::String ("auto")) + " m4", r, {} });
+    }
+
+    // Morphogen's reaction-diffusion on a plane at its automatic size and on a larger one, and the
+    // ring past its automatic time-cell cap.
+    for (int field : { RenderEngine::morphogenPlane, RenderEngine::morphogenRing })
+    {
+        for (int cells : { 0, 1024 })
+        {
+            if (field == RenderEngine::morphogenRing && cells == 0)
+                continue;
+
+            RenderRequest r;
+            r.mode = 4;
+            r.outRate = outRate;
+            r.outSeconds = 3.0f;
+            r.morphogenSynth = RenderEngine::morphogenIFFT;
+            r.morphogenField = field;
+            r.morphogenBins = cells;
+            r.morphogenCells = cells;
+
+            cases.push_back ({ juce::String (field == RenderEngine::morphogenPlane ? "plane " : "ring ")
+                                   + (cells > 0 ? juce::String (cells) : juce::String ("auto")) + " m4", r, {} });
+        }
+    }
+
+    return cases;
+}
+
+juce::String describeBuild()
+{
+    juce::StringArray parts;
+
+   #if defined (__clang__)
+    parts.add ("clang " __clang_version__);
+   #elif defined (__GNUC__)
+    parts.add ("gcc " __VERSION__);
+   #elif defined (_MSC_VER)
+    parts.add ("msvc " + juce::String (_MSC_VER));
+   #endif
+
+   #if JUCE_INTEL
+    parts.add (JUCE_64BIT ? "x86_64" : "x86");
+   #elif JUCE_ARM
+    parts.add (JUCE_64BIT ? "arm64" : "arm");
+   #endif
+
+   #if defined (__AVX512F__)
+    parts.add ("AVX-512");
+   #elif defined (__AVX2__)
+    parts.add ("AVX2");
+   #elif defined (__AVX__)
+    parts.add ("AVX");
+   #elif JUCE_USE_SSE_INTRINSICS
+    parts.add ("SSE2");
+   #elif JUCE_USE_ARM_NEON
+    parts.add ("NEON");
+   #else
+    parts.add ("scalar");
+   #endif
+
+   #if defined (__FAST_MATH__)
+    parts.add ("fast-math");
+   #endif
+
+   #if MICROSOUND_EXACT_MATH
+    parts.add ("exact math");
+   #endif
+
+    return parts.joinIntoString (", ");
+}
+
+juce::File getAudioFile (const juce::File& dir, const VerifyCase& c)
+{
+    return dir.getChildFile (juce::File::createLegalFileName (c.name.replaceCharacter (' ', '_')) + ".wav");
+}
+
+bool writeReferenceAudio (const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    file.deleteFile();
+
+    if (auto fileStream = file.createOutputStream())
+    {
+        std::unique_ptr<juce::OutputStream> stream (std::move (fileStream));
+        juce::WavAudioFormat wav;
+        auto options = juce::AudioFormatWriterOptions {}
+            .withSampleRate (sampleRate)
+            .withNumChannels (buffer.getNumChannels())
+            .withBitsPerSample (32)
+            .withSampleFormat (juce::AudioFormatWriterOptions::SampleFormat::floatingPoint);
+
+        if (auto writer = wav.createWriterFor (stream, options))
+            return writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+    }
+
+    return false;
+}
+
+bool readReferenceAudio (const juce::File& file, juce::AudioBuffer<float>& buffer)
+{
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatReader> reader (wav.createReaderFor (file.createInputStream().release(), true));
+
+    if (reader == nullptr)
+        return false;
+
+    buffer.setSize ((int) reader->numChannels, (int) reader->lengthInSamples);
+    return reader->read (&buffer, 0, buffer.getNumSamples(), 0, true, true);
+}
+
+struct Difference
+{
+    float maxAbs = 0.0f;
+    double snrDb = 0.0;
+};
+
+Difference compare (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& ref)
+{
+    Difference d;
+    double signal = 0.0, noise = 0.0;
+
+    if (a.getNumChannels() != ref.getNumChannels() || a.getNumSamples() != ref.getNumSamples())
+        return { std::numeric_limits<float>::infinity(), -std::numeric_limits<double>::infinity() };
+
+    for (int ch = 0; ch < a.getNumChannels(); ++ch)
+    {
+        const auto* x = a.getReadPointer (ch);
+        const auto* r = ref.getReadPointer (ch);
+
+        for (int i = 0; i < a.getNumSamples(); ++i)
+        {
+            const auto e = x[i] - r[i];
+            d.maxAbs = juce::jmax (d.maxAbs, std::abs (e));
+            signal += (double) r[i] * r[i];
+            noise += (double) e * e;
+        }
+    }
+
+    d.snrDb = noise > 0.0 ? 10.0 * std::log10 (signal / noise) : std::numeric_limits<double>::infinity();
+    return d;
+}
+
+// Runs a diamond of instant tasks over and over, inline and on a pool: every task has to run exactly
+// once, after its dependencies, and run() must not return before all of them have finished.
+juce::String checkTaskGraph()
+{
+    juce::ThreadPool pool (juce::ThreadPoolOptions{}.withThreadName ("unfoldings verify")
+                                                   .withNumberOfThreads (juce::jmax (2, juce::SystemStats::getNumCpus())));
+
+    for (int run = 0; run < 5000; ++run)
+    {
+        std::array<std::atomic<int>, 4> started {}, finished {};
+        std::atomic<bool> ordered { true };
+
+        auto task = [&] (int index, std::initializer_list<int> after)
+        {
+            return [&, index, after = std::vector<int> (after)]
+            {
+                ++started[(size_t) index];
+                for (auto d : after)
+                    if (finished[(size_t) d].load() != 1)
+                        ordered = false;
+                ++finished[(size_t) index];
+            };
+        };
+
+        TaskGraph graph;
+        const auto top = graph.add (task (0, {}));
+        const auto left = graph.add (task (1, { 0 }), { top });
+        const auto right = graph.add (task (2, { 0 }), { top });
+        graph.add (task (3, { 1, 2 }), { left, right });
+        graph.run (run % 8 == 0 ? nullptr : &pool);
+
+        for (size_t i = 0; i < 4; ++i)
+            if (started[i].load() != 1 || finished[i].load() != 1)
+                return "run " + juce::String (run) + ": task " + juce::String ((int) i) + " ran "
+                         + juce::String (started[i].load()) + " times, " + juce::String (finished[i].load()) + " finished before run() returned";
+
+        if (! ordered)
+            return "run " + juce::String (run) + ": a task ran before its dependencies finished";
+    }
+
+    return {};
+}
+
+// Sweeps the engine's fast approximations against libm, in double, and fails if one strays past the
+// error bound its comment in FastMath.h promises.
+juce::String checkFastMath()
+{
+    constexpr double twoPi = juce::MathConstants<double>::twoPi;
+    constexpr int steps = 200000;
+
+    const auto fail = [] (const char* name, double arg, double error, double bound)
+    {
+        return juce::String (name) + " (" + juce::String (arg, 9) + ") is off by " + juce::String (error, 12)
+                 + ", more than " + juce::String (bound, 12);
+    };
+
+    for (const double radius : { 1.0e-3, 1.0, 1.0e3 })
+    {
+        for (int i = 0; i <= steps; ++i)
+        {
+            const auto angle = twoPi * ((double) i / steps - 0.5);
+            const auto y = (float) (radius * std::sin (angle)), x = (float) (radius * std::cos (angle));
+            const auto error = std::abs ((double) FastMath::fastAtan2 (y, x) - std::atan2 ((double) y, (double) x));
+
+            if (error > 4.0e-7)
+                return fail ("fastAtan2", angle, error, 4.0e-7);
+        }
+    }
+
+    for (int i = 0; i <= steps; ++i)
+    {
+        const auto x = (float) (8.0 * i / steps - 4.0);
+        const auto exact = std::exp ((double) x);
+        const auto error = std::abs ((double) FastMath::fastExp (x) - exact) / exact;
+
+        if (error > 5.0e-7)
+            return fail ("fastExp", x, error, 5.0e-7);
+    }
+
+    // Small phases of either sign, then a turn's sweep around large ones either way.
+    for (const double offset : { 0.0, 1.0e3, -1.0e3, 1.0e6 + 0.1, -1.0e6 - 0.3, 1.0e9, -1.0e9 })
+    {
+        for (int i = 0; i <= steps; ++i)
+        {
+            const auto turns = offset + 8.0 * i / steps - 4.0;
+            const auto error = std::abs ((double) FastMath::sinTurns (turns) - std::sin (twoPi * (turns - std::round (turns))));
+
+            if (error > 1.0e-6)
+                return fail ("sinTurns", turns, error, 1.0e-6);
+        }
+    }
+
+    for (int i = 0; i <= steps; ++i)
+    {
+        const auto x = (float) (2.0e4 * i / steps - 1.0e4);
+        const auto wrapped = (double) FastMath::wrapPhase (x);
+        const auto error = std::abs (wrapped - std::remainder ((double) x, twoPi));
+
+        if (error > 2.0e-7 || std::abs (wrapped) > juce::MathConstants<double>::pi + 2.0e-7)
+            return fail ("wrapPhase", x, error, 2.0e-7);
+    }
+
+    return {};
+}
+
+// Sweeps sines through the decimator from every micro rate to common host rates. In the passband
+// the output has to be the input sine at unity gain and in time, leaving a residual that a jittery
+// filter phase would raise; from a little above the host Nyquist up, it has to be gone.
+juce::String checkDecimator()
+{
+    constexpr double twoPi = juce::MathConstants<double>::twoPi;
+    constexpr int numOutput = 4096, margin = 64;
+
+    for (int choice = 0; choice < RenderEngine::numMicroRateChoices; ++choice)
+    {
+        for (const double outRate : { 44100.0, 48000.0 })
+        {
+            const auto inRate = RenderEngine::getMicroRateForChoice (choice);
+            const auto decimator = Decimator::get (inRate, outRate);
+            const auto numInput = (int) std::ceil (numOutput * inRate / outRate);
+            std::vector<float> input ((size_t) numInput), output ((size_t) numOutput);
+
+            for (const double fraction : { 0.01, 0.05, 0.1, 0.2, 0.3, 0.4, 0.6, 0.8, 1.3, 2.9 })
+            {
+                const auto hz = fraction * outRate;
+                for (int i = 0; i < numInput; ++i)
+                    input[(size_t) i] = (float) std::sin (twoPi * hz * i / inRate);
+
+                decimator->process (input.data(), numInput, output.data(), numOutput);
+
+                // Least-squares fit of a sine and cosine at hz over the output away from its ends.
+                double ss = 0.0, sc = 0.0, cc = 0.0, ys = 0.0, yc = 0.0, yy = 0.0;
+                for (int i = margin; i < numOutput - margin; ++i)
+                {
+                    const auto sn = std::sin (twoPi * hz * i / outRate), cs = std::cos (twoPi * hz * i / outRate);
+                    const auto y = (double) output[(size_t) i];
+                    ss += sn * sn; sc += sn * cs; cc += cs * cs;
+                    ys += y * sn; yc += y * cs; yy += y * y;
+                }
+
+                const auto det = ss * cc - sc * sc;
+                const auto a = (ys * cc - yc * sc) / det, b = (yc * ss - ys * sc) / det;
+                const auto count = (double) (numOutput - 2 * margin);
+                const auto residualDb = 10.0 * std::log10 (juce::jmax (1.0e-30, (yy - a * ys - b * yc) / count) / 0.5);
+                const auto levelDb = 10.0 * std::log10 (juce::jmax (1.0e-30, yy / count) / 0.5);
+                const auto gainDb = 20.0 * std::log10 (std::sqrt (a * a + b * b));
+                const auto phase = std::atan2 (b, a);
+
+                const auto where = juce::String (inRate / 1000.0, 0) + " kHz to " + juce::String (outRate / 1000.0, 1)
+                                 + " kHz at " + juce::String (hz / 1000.0, 2) + " kHz: ";
+
+                if (fraction < 0.5)
+                {
+                    if (std::abs (gainDb) > 0.1 || std::abs (phase) > 1.0e-4)
+                        return where + "gain " + juce::String (gainDb, 3) + " dB, phase " + juce::String (phase, 6) + " rad";
+
+                    if (residualDb > -95.0)
+                        return where + "residual " + juce::String (residualDb, 1) + " dB";
+                }
+                else if (levelDb > -80.0)
+                {
+                    return where + "stopband leaks at " + juce::String (levelDb, 1) + " dB";
+                }
+            }
+        }
+    }
+
+    return {};
+}
+
+struct SelfCheck
+{
+    juce::String name;
+    std::function<juce::String()> run;   // returns a description of the failure, or an empty string
+};
+
+std::vector<SelfCheck> makeSelfChecks()
+{
+    return { { "task graph, 5000 diamond runs", checkTaskGraph },
+             { "fast math against libm", checkFastMath },
+             { "decimator sine sweep", checkDecimator } };
+}
+
+void printUsage()
+{
+    std::cout << "usage: unfoldings-verify [--reference <file.json>] [--threads <n,n,...>] [--audio <dir>]\n"
+                 "                         [--max-abs <x>] [--min-snr <dB>] [--record] [--rate <Hz>]\n";
+}
+}
+
+int main (int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add (argv[i]);
+
+    if (args.contains ("--help") || args.contains ("-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    juce::File referenceFile = cwd.getChildFile ("Reference/render-hashes.json");
+    juce::File audioDir;
+    juce::Array<int> threadCounts { 0, juce::SystemStats::getNumCpus() };
+    float maxAbs = std::numeric_limits<float>::infinity();
+    double minSnrDb = -std::numeric_limits<double>::infinity();
+    bool tolerant = false; // set once either tolerance is given; otherwise only exact output passes
+    bool record = false;
+    double outRate = 44100.0;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const auto hasValue = i + 1 < args.size();
+
+        if (arg == "--reference" && hasValue)   referenceFile = cwd.getChildFile (args[++i]);
+        else if (arg == "--audio" && hasValue)  audioDir = cwd.getChildFile (args[++i]);
+        else if (arg == "--max-abs" && hasValue) { maxAbs = args[++i].getFloatValue(); tolerant = true; }
+        else if (arg == "--min-snr" && hasValue) { minSnrDb = args[++i].getDoubleValue(); tolerant = true; }
+        else if (arg == "--rate" && hasValue)   outRate = juce::jmax (8000.0, args[++i].getDoubleValue());
+        else if (arg == "--record")             record = true;
+        else if (arg == "--threads" && hasValue)
+        {
+            threadCounts.clear();
+            for (const auto& t : juce::StringArray::fromTokens (args[++i], ",", {}))
+                threadCounts.addIfNotAlreadyThere (juce::jmax (0, t.getIntValue()));
+        }
+        else
+        {
+            std::cerr << "unrecognised argument: " << arg << "\n";
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (threadCounts.isEmpty())
+        threadCounts.add (0);
+
+    std::cout << "build: " << describeBuild() << "\n";
+
+    bool selfChecksPassed = true;
+    for (const auto& check : makeSelfChecks())
+    {
+        const auto problem = check.run();
+        std::cout << ("self-check: " + check.name).paddedRight (' ', 64) << (problem.isEmpty() ? "ok" : "FAIL (" + problem + ")") << "\n";
+        selfChecksPassed = selfChecksPassed && problem.isEmpty();
+    }
+
+    if (! selfChecksPassed)
+    {
+        std::cerr << "self-checks failed, nothing rendered\n";
+        return 1;
+    }
+
+    std::vector<VerifyCase> cases;
+    if (record)
+    {
+        cases = makeCases (outRate);
+    }
+    else
+    {
+        const auto reference = juce::JSON::parse (referenceFile);
+        if (auto* list = reference.getProperty ("cases", {}).getArray())
+            for (const auto& c : *list)
+                cases.push_back ({ c.getProperty ("name", {}).toString(), requestFromVar (c.getProperty ("request", {})), c.getProperty ("hash", {}).toString() });
+
+        if (cases.empty())
+        {
+            std::cerr << "no reference cases in " << referenceFile.getFullPathName() << " (run with --record first)\n";
+            return 1;
+        }
+
+        std::cout << "reference: " << referenceFile.getFullPathName() << " (" << reference.getProperty ("build", {}).toString() << ")\n";
+    }
+
+    if (record)
+    {
+        const auto threads = threadCounts.getFirst();
+        std::unique_ptr<juce::ThreadPool> pool;
+        if (threads > 0)
+            pool = std::make_unique<juce::ThreadPool> (juce::ThreadPoolOptions{}.withThreadName ("unfoldings verify").withNumberOfThreads (threads));
+
+        const RenderEngine engine (nullptr, pool.get());
+        juce::Array<juce::var> list;
+
+        if (audioDir != juce::File())
+            audioDir.createDirectory();
+
+        for (auto& c : cases)
+        {
+            const auto result = engine.render (c.request);
+            c.hash = hashBuffer (result.buffer);
+            std::cout << c.hash << "  " << c.name << "\n";
+
+            if (audioDir != juce::File() && ! writeReferenceAudio (getAudioFile (audioDir, c), result.buffer, result.sampleRate))
+                std::cerr << "could not write reference audio for " << c.name << "\n";
+
+            auto* o = new juce::DynamicObject();
+            o->setProperty ("name", c.name);
+            o->setProperty ("hash", c.hash);
+            o->setProperty ("request", requestToVar (c.request));
+            list.add (juce::var (o));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty ("build", describeBuild());
+        root->setProperty ("cases", list);
+
+        referenceFile.getParentDirectory().createDirectory();
+        if (! referenceFile.replaceWithText (juce::JSON::toString (juce::var (root))))
+        {
+            std::cerr << "could not write " << referenceFile.getFullPathName() << "\n";
+            return 1;
+        }
+
+        std::cout << cases.size() << " reference hashes written to " << referenceFile.getFullPathName() << "\n";
+        return 0;
+    }
+
+    struct Variant
+    {
+        juce::String name;
+        int threads;
+        bool cached;
+    };
+
+    std::vector<Variant> variants;
+    for (auto t : threadCounts)
+        variants.push_back ({ "threads=" + juce::String (t), t, false });
+    variants.push_back ({ "cached, threads=" + juce::String (threadCounts.getFirst()), threadCounts.getFirst(), true });
+
+    int exact = 0, tolerated = 0, failed = 0;
+
+    for (const auto& variant : variants)
+    {
+        std::unique_ptr<juce::ThreadPool> pool;
+        if (variant.threads > 0)
+            pool = std::make_unique<juce::ThreadPool> (juce::ThreadPoolOptions{}.withThreadName ("unfoldings verify").withNumberOfThreads (variant.threads));
+
+        RenderCache cache;
+        const RenderEngine engine (variant.cached ? &cache : nullptr, pool.get());
+
+        for (const auto& c : cases)
+        {
+            const auto result = engine.render (c.request);
+            const auto hash = hashBuffer (result.buffer);
+            juce::String verdict = "exact";
+
+            if (hash == c.hash)
+            {
+                ++exact;
+            }
+            else
+            {
+                juce::AudioBuffer<float> ref;
+                const auto refFile = audioDir != juce::File() ? getAudioFile (audioDir, c) : juce::File();
+
+                if (refFile.existsAsFile() && readReferenceAudio (refFile, ref))
+                {
+                    const auto d = compare (result.buffer, ref);
+                    const bool ok = tolerant && d.maxAbs <= maxAbs && d.snrDb >= minSnrDb;
+                    verdict = juce::String (ok ? "within tolerance" : "FAIL") + " (max abs " + juce::String (d.maxAbs, 9)
+                                + ", SNR " + juce::String (d.snrDb, 1) + " dB)";
+
+                    if (ok)
+                        ++tolerated;
+                    else
+                        ++failed;
+                }
+                else
+                {
+                    verdict = "FAIL (hash " + hash + ", no reference audio)";
+                    ++failed;
+                }
+            }
+
+            std::cout << variant.name.paddedRight (' ', 22) << c.name.substring (0, 40).paddedRight (' ', 42) << verdict << "\n";
+        }
+    }
+
+    std::cout << "\n" << exact << " exact, " << tolerated << " within tolerance, " << failed << " failed\n";
+    return failed == 0 ? 0 : 1;
+}